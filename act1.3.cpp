@@ -10,222 +10,569 @@
 
 // Incluir bibliotecas necesarias
 #include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstring>
 #include <fstream>
 #include <iostream>
 #include <sstream>
 #include <string>
-#include <unordered_map>
 #include <vector>
 
+#include <sys/stat.h>
+
+#include "common/async_files.h"
+#include "common/log_tokenizer.h"
+#include "common/parallel_loader.h"
+#include "common/sort_kernels.h"
+
 using namespace std;
 
-// Estructura para almacenar un registro de bitácora
+// Segmento (posición, longitud) dentro del búfer con el archivo de entrada
+struct Span {
+    size_t offset;
+    size_t length;
+};
+
+// Estructura para almacenar un registro de bitácora.
+// La fecha y la hora se guardan en campos fijos dentro del registro y la IP y el mensaje
+// como segmentos del búfer de entrada, así que un registro nunca reserva memoria.
+// Solo se puede mover: ordenar y agregar registros nunca hace copias por accidente.
 struct LogEntry {
-    string date;  
-    string time;
-    string ip;
-    string message;
+    char date[5]; // "MM-DD"
+    char time[8]; // "hh:mm:ss"
+    Span ip;
+    Span message;
+    int timestamp; // Segundos transcurridos desde el inicio del año
+
+    LogEntry() = default;
+    LogEntry(LogEntry&&) = default;
+    LogEntry& operator=(LogEntry&&) = default;
+    LogEntry(const LogEntry&) = delete;
+    LogEntry& operator=(const LogEntry&) = delete;
 
     // Comparación para ordenamiento
     bool operator<(const LogEntry& other) const {
-        return date + time < other.date + other.time;
+        return timestamp < other.timestamp;
     }
 };
 
+// Días transcurridos antes de cada mes (1-12); se usa un año bisiesto para aceptar el 29 de febrero
+const int DAYS_BEFORE_MONTH[13] = {0, 0, 31, 60, 91, 121, 152, 182, 213, 244, 274, 305, 335};
+
+// Cantidad de cubetas del índice de tiempo (una por hora del año)
+const int HOURS_PER_YEAR = 366 * 24;
+
 
 /*
-* Función para obtener el número del mes desde su nombre abreviado
+* Función para copiar un campo de texto a un campo fijo del registro
+* Los campos más cortos se completan con ceros a la izquierda (por ejemplo, el día "5"
+* o la hora "9:05:00") y los más largos se recortan.
+* Complejidad: O(m), donde m es el tamaño del campo.
+* Parametros:
+* field Campo fijo del registro
+* size Tamaño del campo
+* text Texto a copiar
+* length Longitud del texto
+*/
+void copyField(char* field, size_t size, const char* text, size_t length) {
+    size_t padding = length < size ? size - length : 0;
+    memset(field, '0', padding);
+    memcpy(field + padding, text, size - padding);
+}
+
+
+/*
+* Función para convertir una fecha y hora a segundos desde el inicio del año
 * Complejidad: O(1).
 * Parametros:
-* month Nombre abreviado del mes
-* Return: 
-*  Número del mes en formato de dos dígitos
+* month Mes (1-12)
+* day Día del mes
+* hour, minute, second Hora del día
+* Return:
+*  Segundos transcurridos desde el 1 de enero a las 00:00:00
 */
-string getMonthNumber(const string& month) {
-    unordered_map<string, string> monthMap = {
-        {"Jan", "01"}, {"Feb", "02"}, {"Mar", "03"}, {"Apr", "04"},
-        {"May", "05"}, {"Jun", "06"}, {"Jul", "07"}, {"Aug", "08"},
-        {"Sep", "09"}, {"Oct", "10"}, {"Nov", "11"}, {"Dec", "12"}
-    };
+int toTimestamp(int month, int day, int hour, int minute, int second) {
+    if (month < 1 || month > 12) month = 0; // Mes inválido: se ordena al inicio
+    int dayOfYear = DAYS_BEFORE_MONTH[month] + day - 1;
+    return ((dayOfYear * 24 + hour) * 60 + minute) * 60 + second;
+}
+
+
+/*
+* Función para calcular la marca de tiempo de un registro a partir de su fecha y hora
+* Complejidad: O(1).
+* Parametros:
+* date Fecha en formato MM-DD
+* dateLength Longitud de la fecha
+* time Hora en formato hh:mm:ss
+* timeLength Longitud de la hora
+* Return:
+*  Segundos transcurridos desde el inicio del año
+*/
+int entryTimestamp(const char* date, size_t dateLength, const char* time, size_t timeLength) {
+    const char* pos = date;
+    const char* end = pos + dateLength;
+    int month = readNumber(pos, end);
+    if (pos < end) ++pos; // Saltar el guion
+    int day = readNumber(pos, end);
+
+    int hour = 0, minute = 0, second = 0;
+    parseClock(time, timeLength, hour, minute, second);
+    return toTimestamp(month, day, hour, minute, second);
+}
+
+
+/*
+* Función para obtener la cubeta (hora del año) de una marca de tiempo
+* Complejidad: O(1).
+* Parametros:
+* timestamp Segundos desde el inicio del año
+* Return:
+*  Índice de la cubeta entre 0 y HOURS_PER_YEAR - 1
+*/
+int hourBucket(int timestamp) {
+    return min(max(timestamp / 3600, 0), HOURS_PER_YEAR - 1);
+}
+
+
+/*
+* Función para interpretar una línea de la bitácora original
+* ("Mes día hh:mm:ss IP mensaje"). Solo la fecha y hora (necesarias para ordenar)
+* se copian a los campos fijos; la IP y el mensaje quedan como segmentos del búfer.
+* Complejidad: O(k), donde k es la longitud de la línea.
+* Parametros:
+* buffer Búfer con el contenido del archivo
+* lineStart Posición del inicio de la línea
+* lineEnd Posición del fin de la línea (sin el salto de línea)
+* log Registro donde se almacenará el resultado
+* Return:
+*  false si la línea está vacía o incompleta
+*/
+bool parseLogLine(const LargeString& buffer, size_t lineStart, size_t lineEnd, LogEntry& log) {
+    // Leer componentes de la línea
+    LineTokens tokens;
+    if (!tokenizeLine(buffer.data() + lineStart, lineEnd - lineStart, tokens)) { // Línea vacía o incompleta
+        return false;
+    }
+    Span month = {lineStart + tokens.start[0], tokens.end[0] - tokens.start[0]};
+    Span day = {lineStart + tokens.start[1], tokens.end[1] - tokens.start[1]};
+    Span time = {lineStart + tokens.start[2], tokens.end[2] - tokens.start[2]};
+    Span ip = {lineStart + tokens.start[3], tokens.end[3] - tokens.start[3]};
+    Span message = {lineStart + tokens.rest, lineEnd - lineStart - tokens.rest}; // El mensaje es el resto de la línea
+
+    // Convertir mes a número (tabla construida en compilación; "00" si el mes no es válido)
+    memcpy(log.date, MONTH_NUMBERS[monthFromName(buffer.data() + month.offset, month.length)], 2);
+    log.date[2] = '-';
+
+    // Formatear el día a dos dígitos (si el día es menor a 10, agregar un 0)
+    if (buffer[day.offset + day.length - 1] == ',') day.length--; // Eliminar cualquier coma
+    copyField(log.date + 3, 2, buffer.data() + day.offset, day.length);
+
+    copyField(log.time, sizeof(log.time), buffer.data() + time.offset, time.length);
+    log.ip = ip;
+    log.message = message;
+    log.timestamp = entryTimestamp(log.date, sizeof(log.date), buffer.data() + time.offset, time.length);
+    return true;
+}
+
 
-    auto it = monthMap.find(month);
-    if (it != monthMap.end()) {
-        return it->second;
+/*
+* Función para interpretar una línea de un archivo ordenado por este programa
+* (formato "MM-DD hh:mm:ss IP - mensaje").
+* Complejidad: O(k), donde k es la longitud de la línea.
+* Parametros:
+* buffer Búfer con el contenido del archivo
+* lineStart Posición del inicio de la línea
+* lineEnd Posición del fin de la línea (sin el salto de línea)
+* log Registro donde se almacenará el resultado
+* Return:
+*  false si la línea está vacía o incompleta
+*/
+bool parseSortedLogLine(const LargeString& buffer, size_t lineStart, size_t lineEnd, LogEntry& log) {
+    LineTokens tokens;
+    tokenizeLine(buffer.data() + lineStart, lineEnd - lineStart, tokens);
+    if (tokens.count < 3) { // Línea vacía o incompleta
+        return false;
     }
-    return "00"; // En caso de que el mes no sea válido
+    Span date = {lineStart + tokens.start[0], tokens.end[0] - tokens.start[0]};
+    Span time = {lineStart + tokens.start[1], tokens.end[1] - tokens.start[1]};
+    Span ip = {lineStart + tokens.start[2], tokens.end[2] - tokens.start[2]};
+    size_t pos = ip.offset + ip.length;
+    if (pos + 3 <= lineEnd && buffer.compare(pos, 3, " - ") == 0) pos += 3; // Separador agregado por writeEntry
+    Span message = {pos, lineEnd - pos};
+
+    copyField(log.date, sizeof(log.date), buffer.data() + date.offset, date.length);
+    copyField(log.time, sizeof(log.time), buffer.data() + time.offset, time.length);
+    log.ip = ip;
+    log.message = message;
+    log.timestamp = entryTimestamp(buffer.data() + date.offset, date.length, buffer.data() + time.offset, time.length);
+    return true;
 }
 
 
 /*
 * Función para cargar los datos desde el archivo
+* El archivo se carga en un búfer con el pipeline de loadParallel (lectura, interpretación
+* en varios hilos y consumo en orden); los registros guardan segmentos hacia el búfer.
+* Compilado con C++20 las lecturas son asíncronas (loadParallelAsync de common/async_files.h).
 * Complejidad: O(n), donde n es la cantidad de líneas en el archivo.
 * Parametros:
 * filename Nombre del archivo a cargar
+* buffer Búfer donde se almacenará el contenido del archivo
 * logs Vector donde se almacenarán los registros
+* sorted true si el archivo es una salida ordenada de este programa
+* threads, chunkSize Hilos y tamaño de segmento del pipeline (igual que en loadParallel)
 */
-void loadLogFile(const string& filename, vector<LogEntry>& logs) {
-    ifstream file(filename);
-    if (!file.is_open()) {
+void loadLogFile(const string& filename, LargeString& buffer, vector<LogEntry>& logs, bool sorted = false,
+                 unsigned threads = 0, size_t chunkSize = 4 << 20) {
+    auto append = [&](vector<LogEntry>&& batch) {
+        reserveFromFirstBatch(logs, batch, buffer.size()); // Una sola reserva para todos los registros
+        logs.insert(logs.end(), make_move_iterator(batch.begin()), make_move_iterator(batch.end()));
+    };
+
+    bool opened = sorted ? loadParallelAsync<LogEntry>(filename, buffer, parseSortedLogLine, append, threads, chunkSize)
+                         : loadParallelAsync<LogEntry>(filename, buffer, parseLogLine, append, threads, chunkSize);
+    if (!opened) {
         cerr << "Error al abrir el archivo: " << filename << endl;
-        return;
     }
+}
 
-    string line;
-    while (getline(file, line)) {
-        stringstream ss(line);
-        string month, day, time, ip, message;
-
-        // Leer componentes de la línea
-        ss >> month >> day >> time >> ip;
-        getline(ss, message); // Leer el mensaje restante
-
-        // Convertir mes a número
-        string monthNumber = getMonthNumber(month);
-
-        // Formatear el día a dos dígitos
-        if (day.back() == ',') day.pop_back(); // Eliminar cualquier coma
-        if (stoi(day) < 10) { // Si el día es menor a 10, agregar un 0
-            day = "0" + day;
-        }
 
-        // Formatear la fecha como MM-DD
-        string date = monthNumber + "-" + day;
+/*
+* Función para escribir un registro con el formato "MM-DD hh:mm:ss IP - mensaje"
+* La IP y el mensaje se copian directamente desde el búfer de entrada.
+* Complejidad: O(k), donde k es la longitud de la línea.
+* Parametros:
+* out Flujo de salida
+* buffer Búfer con el contenido del archivo de entrada
+* log Registro a escribir
+*/
+void writeEntry(ostream& out, const LargeString& buffer, const LogEntry& log) {
+    out.write(log.date, sizeof(log.date));
+    out << ' ';
+    out.write(log.time, sizeof(log.time));
+    out << ' ';
+    out.write(buffer.data() + log.ip.offset, log.ip.length);
+    out << " - ";
+    out.write(buffer.data() + log.message.offset, log.message.length);
+    out << '\n';
+}
 
-        // Almacenar el registro en el vector
-        logs.push_back({date, time, ip, message});
-    }
 
-    file.close();
+/*
+* Función para agregar un registro con el formato de writeEntry al final de un bloque de texto
+* Complejidad: O(k), donde k es la longitud de la línea.
+* Parametros:
+* out Bloque de texto
+* buffer Búfer con el contenido del archivo de entrada
+* log Registro a agregar
+*/
+void appendEntry(string& out, const LargeString& buffer, const LogEntry& log) {
+    out.append(log.date, sizeof(log.date));
+    out += ' ';
+    out.append(log.time, sizeof(log.time));
+    out += ' ';
+    out.append(buffer.data() + log.ip.offset, log.ip.length);
+    out.append(" - ");
+    out.append(buffer.data() + log.message.offset, log.message.length);
+    out += '\n';
 }
 
 
 /*
 * Función para escribir los registros ordenados en un archivo
+* Los registros se escriben por bloques con writeBlocksAsync (asíncrona con C++20: se da
+* formato a un bloque mientras se escribe el anterior).
 * Complejidad: O(n), donde n es la cantidad de registros.
 * Parametros:
 * outputFile Nombre del archivo de salida
+* buffer Búfer con el contenido del archivo de entrada
 * logs Vector con los registros a escribir
 */
-void writeLogsToFile(const string& outputFile, const vector<LogEntry>& logs) {
-    ofstream file(outputFile);
-    if (!file.is_open()) {
-        cerr << "Error al abrir el archivo de salida: " << outputFile << endl;
+void writeLogsToFile(const string& outputFile, const LargeString& buffer, const vector<LogEntry>& logs) {
+    size_t next = 0;
+    bool written = writeBlocksAsync(outputFile, [&](string& block, size_t limit) {
+        while (next < logs.size() && block.size() < limit) {
+            appendEntry(block, buffer, logs[next++]);
+        }
+        return next < logs.size();
+    });
+    if (!written) {
+        cerr << "Error al escribir el archivo de salida: " << outputFile << endl;
         return;
     }
 
-    for (const auto& log : logs) {
-        file << log.date << " " << log.time << " " << log.ip << " - " << log.message << endl;
-    }
-
-    file.close();
     cout << "Registros ordenados guardados en el archivo: " << outputFile << endl;
 }
 
 
 // Implementación de Quick Sort
 /*
-* Función para particionar el vector de registros
-* Complejidad: O(n), donde n es la cantidad de registros.
+* Función para ordenar los registros usando Quick Sort
+* El núcleo (mediana de tres, partición de Hoare e inserción en rangos pequeños) está en
+* common/sort_kernels.h y se especializa en compilación para la clave de tiempo.
+* Complejidad: O(n log n) en promedio.
 * Parametros:
 * logs Vector con los registros a ordenar
 * low Índice del primer elemento
 * high Índice del último elemento
 */
-int partition(vector<LogEntry>& logs, int low, int high) {
-    LogEntry pivot = logs[high];
-    int i = low - 1;
+void quickSort(vector<LogEntry>& logs, int low, int high) {
+    if (low < high) {
+        quickSortBy<TimestampKey>(logs.begin() + low, logs.begin() + high + 1);
+    }
+}
+
+
+// Implementación del índice de tiempo
+/*
+* Función para construir el índice de tiempo de los registros ordenados.
+* index[h] es la posición del primer registro cuya hora del año es >= h, por lo que
+* los registros de la hora h ocupan las posiciones [index[h], index[h + 1]).
+* Complejidad: O(n + H), donde H es la cantidad de horas del año.
+* Parametros:
+* logs Vector con los registros ordenados
+* Return: Vector con HOURS_PER_YEAR + 1 posiciones iniciales
+*/
+vector<int> buildTimeIndex(const vector<LogEntry>& logs) {
+    vector<int> index(HOURS_PER_YEAR + 1);
+    int i = 0;
+    int n = logs.size();
+    for (int bucket = 0; bucket <= HOURS_PER_YEAR; ++bucket) {
+        while (i < n && hourBucket(logs[i].timestamp) < bucket) ++i;
+        index[bucket] = i;
+    }
+    return index;
+}
+
+
+/*
+* Función para obtener la firma de un archivo: su tamaño y su fecha de modificación
+* en nanosegundos. Si el archivo se reescribe (por ejemplo, con el modo incremental del
+* programa de análisis), la firma cambia aunque conserve la cantidad de registros.
+* Complejidad: O(1).
+* Parametros:
+* filename Nombre del archivo
+* size Tamaño del archivo en bytes
+* modified Fecha de modificación en nanosegundos
+* Return: true si el archivo existe
+*/
+bool fileSignature(const string& filename, long long& size, long long& modified) {
+    struct stat status;
+    if (stat(filename.c_str(), &status) != 0) {
+        return false;
+    }
+    size = status.st_size;
+    modified = status.st_mtim.tv_sec * 1000000000LL + status.st_mtim.tv_nsec;
+    return true;
+}
 
-    for (int j = low; j < high; ++j) {
-        if (logs[j] < pivot) {
-            ++i;
-            swap(logs[i], logs[j]);
+
+/*
+* Función para guardar el índice de tiempo junto al archivo ordenado, con la firma del
+* archivo ordenado para detectar después si el índice ya no le corresponde
+* Complejidad: O(H), donde H es la cantidad de horas del año.
+* Parametros:
+* filename Nombre del archivo del índice
+* sortedFile Nombre del archivo ordenado (ya escrito y cerrado)
+* recordCount Cantidad de registros del archivo ordenado
+* index Índice de tiempo
+*/
+void saveTimeIndex(const string& filename, const string& sortedFile, int recordCount, const vector<int>& index) {
+    long long size = 0, modified = 0;
+    if (!fileSignature(sortedFile, size, modified)) {
+        cerr << "Error al leer el archivo ordenado: " << sortedFile << endl;
+        return;
+    }
+    ofstream file(filename);
+    if (!file.is_open()) {
+        cerr << "Error al abrir el archivo del índice: " << filename << endl;
+        return;
+    }
+
+    file << "INDICE_TIEMPO 2 " << recordCount << " " << index.size() << " " << size << " " << modified << '\n';
+    for (int start : index) {
+        file << start << '\n';
+    }
+}
+
+
+/*
+* Función para cargar un índice de tiempo guardado por saveTimeIndex
+* Complejidad: O(H), donde H es la cantidad de horas del año.
+* Parametros:
+* filename Nombre del archivo del índice
+* sortedFile Nombre del archivo ordenado del que se cargaron los registros
+* recordCount Cantidad de registros cargados del archivo ordenado
+* index Vector donde se almacenará el índice
+* Return: true si el índice existe y corresponde al archivo ordenado actual
+*/
+bool loadTimeIndex(const string& filename, const string& sortedFile, int recordCount, vector<int>& index) {
+    ifstream file(filename);
+    string tag;
+    int version = 0, savedCount = 0;
+    size_t size = 0;
+    long long savedBytes = 0, savedModified = 0, bytes = 0, modified = 0;
+    if (!(file >> tag >> version >> savedCount >> size >> savedBytes >> savedModified) || tag != "INDICE_TIEMPO" ||
+        version != 2 || savedCount != recordCount || size != HOURS_PER_YEAR + 1) {
+        return false;
+    }
+    // Un índice de otro archivo (o de una versión anterior de este) se reconstruye
+    if (!fileSignature(sortedFile, bytes, modified) || bytes != savedBytes || modified != savedModified) {
+        return false;
+    }
+
+    index.assign(size, 0);
+    for (size_t i = 0; i < size; ++i) {
+        if (!(file >> index[i]) || index[i] < (i > 0 ? index[i - 1] : 0) || index[i] > recordCount) {
+            return false;
         }
     }
-    swap(logs[i + 1], logs[high]);
-    return i + 1;
+    return true;
 }
 
 
 /*
-* Función para ordenar los registros usando Quick Sort
-* Complejidad: O(n log n) en promedio, O(n^2) en el peor caso.
+* Funcion para interpretar una fecha de consulta con formato "MM-DD", "MM-DD hh",
+* "MM-DD hh:mm" o "MM-DD hh:mm:ss". Las partes omitidas toman el inicio del día
+* (o el final, si es el límite superior del rango).
+* Complejidad: O(1).
 * Parametros:
-* logs Vector con los registros a ordenar
-* low Índice del primer elemento
-* high Índice del último elemento
+* text Texto capturado por el usuario
+* endOfRange true si la fecha es el límite superior del rango
+* timestamp Marca de tiempo resultante
+* Return: true si el texto tiene un formato válido
 */
-void quickSort(vector<LogEntry>& logs, int low, int high) {
-    if (low < high) {
-        int pi = partition(logs, low, high);
-        quickSort(logs, low, pi - 1);
-        quickSort(logs, pi + 1, high);
+bool parseQueryTime(const string& text, bool endOfRange, int& timestamp) {
+    int month, day;
+    int hour = endOfRange ? 23 : 0, minute = endOfRange ? 59 : 0, second = endOfRange ? 59 : 0;
+    if (sscanf(text.c_str(), "%d-%d %d:%d:%d", &month, &day, &hour, &minute, &second) < 2) {
+        return false;
     }
+    timestamp = toTimestamp(month, day, hour, minute, second);
+    return true;
 }
 
 
-// Implementación de búsqueda binaria
 /*
-* Funcion para buscar registros dentro de un rango de fechas
-* Complejidad: O(log n) para cada búsqueda.
+* Funcion para buscar registros dentro de un rango de fechas usando el índice de tiempo.
+* La cubeta de cada límite se obtiene directamente y dentro de esa hora se hace una
+* búsqueda binaria por la clave de tiempo.
+* Complejidad: O(log k), donde k es la cantidad de registros en la hora de cada límite.
 * Parametros:
 * logs Vector con los registros ordenados
-* startDate Fecha de inicio del rango
-* endDate Fecha de fin del rango
+* index Índice de tiempo de los registros
+* startTime Marca de tiempo de inicio del rango
+* endTime Marca de tiempo de fin del rango (inclusiva)
 * Return: Par de índices que delimitan el rango de fechas
 */
-pair<int, int> binarySearch(const vector<LogEntry>& logs, const string& startDate, const string& endDate) {
-    auto startIt = lower_bound(logs.begin(), logs.end(), LogEntry{startDate, "", "", ""});
-    auto endIt = upper_bound(logs.begin(), logs.end(), LogEntry{endDate, "23:59:59", "", ""});
-    
-    if (endIt == logs.end() || endIt->date < startDate) {
+pair<int, int> searchRange(const vector<LogEntry>& logs, const vector<int>& index, int startTime, int endTime) {
+    if (startTime > endTime) {
+        return {-1, -1};
+    }
+
+    int startBucket = hourBucket(startTime);
+    int first = lowerBoundBy<TimestampKey>(logs.begin() + index[startBucket],
+                                           logs.begin() + index[startBucket + 1], startTime) - logs.begin();
+
+    int endBucket = hourBucket(endTime);
+    int last = upperBoundBy<TimestampKey>(logs.begin() + index[endBucket],
+                                          logs.begin() + index[endBucket + 1], endTime) - logs.begin();
+
+    if (first >= last) {
         return {-1, -1}; // No hay registros en el rango
     }
-    
-    if (startIt == logs.end() || startIt->date > startDate) {
-    int endIndex = (endIt == logs.end()) ? logs.size() - 1 : distance(logs.begin(), endIt) - 1;
-    return {distance(logs.begin(), startIt), endIndex};
+    return {first, last - 1};
+}
+
+
+/*
+* Función para obtener la cantidad de registros por hora del día a partir del índice
+* Complejidad: O(H), donde H es la cantidad de horas del año.
+* Parametros:
+* index Índice de tiempo de los registros
+* Return: Cantidad de registros para cada hora del día (0-23)
+*/
+array<int, 24> countByHourOfDay(const vector<int>& index) {
+    array<int, 24> counts = {};
+    for (int bucket = 0; bucket < HOURS_PER_YEAR; ++bucket) {
+        counts[bucket % 24] += index[bucket + 1] - index[bucket];
     }
-    
-    return {distance(logs.begin(), startIt), distance(logs.begin(), endIt) - 1};
+    return counts;
 }
 
-// Función principal de la aplicación
-int main() {
+// Función principal de la aplicación.
+// Con el argumento "--consulta" se reutilizan el archivo ordenado y su índice de una
+// ejecución anterior en lugar de volver a cargar y ordenar la bitácora.
+int main(int argc, char* argv[]) {
     // Variables para almacenar registros
+    LargeString buffer; // Contenido del archivo de entrada (referenciado por los registros)
     vector<LogEntry> logs;
+    vector<int> index;
     string inputFile = "bitacora.txt";
     string outputFile = "sorted_logs.txt";
-
-    // Cargar datos del archivo
-    loadLogFile(inputFile, logs);
+    string indexFile = outputFile + ".idx";
+    bool queryOnly = argc > 1 && string(argv[1]) == "--consulta";
+
+    if (queryOnly) {
+        // Cargar los registros ya ordenados y su índice
+        loadLogFile(outputFile, buffer, logs, true);
+        if (!loadTimeIndex(indexFile, outputFile, logs.size(), index)) {
+            index = buildTimeIndex(logs);
+            saveTimeIndex(indexFile, outputFile, logs.size(), index);
+        }
+    } else {
+        // Cargar datos del archivo
+        loadLogFile(inputFile, buffer, logs);
+    }
     // Manejo de excepción
     if (logs.empty()) {
         cout << "No se encontraron registros para procesar." << endl;
         return 1;
     }
 
-    // Ordenar registros usando Quick Sort
-    quickSort(logs, 0, logs.size() - 1);
+    if (!queryOnly) {
+        // Ordenar registros usando Quick Sort
+        quickSort(logs, 0, logs.size() - 1);
 
-    // Guardar registros ordenados en un archivo
-    writeLogsToFile(outputFile, logs);
+        // Guardar registros ordenados y su índice de tiempo
+        writeLogsToFile(outputFile, buffer, logs);
+        index = buildTimeIndex(logs);
+        saveTimeIndex(indexFile, outputFile, logs.size(), index);
+    }
 
     // Solicitar fechas al usuario
     string startDate, endDate;
-    cout << "Ingrese la fecha de inicio (MM-DD): ";
-    cin >> startDate;
-    cout << "Ingrese la fecha de fin (MM-DD): ";
-    cin >> endDate;
+    cout << "Ingrese la fecha de inicio (MM-DD [hh:mm:ss]): ";
+    getline(cin >> ws, startDate);
+    cout << "Ingrese la fecha de fin (MM-DD [hh:mm:ss]): ";
+    getline(cin >> ws, endDate);
+
+    int startTime, endTime;
+    if (!parseQueryTime(startDate, false, startTime) || !parseQueryTime(endDate, true, endTime)) {
+        cout << "Formato de fecha inválido." << endl;
+        return 1;
+    }
 
-    // Buscar registros dentro del rango de fechas usando búsqueda binaria
-    auto range = binarySearch(logs, startDate, endDate);
+    // Buscar registros dentro del rango de fechas usando el índice de tiempo
+    auto range = searchRange(logs, index, startTime, endTime);
 
     if (range.first == -1) {
         cout << "No se encontraron registros en el rango de fechas especificado." << endl;
     } else {
         cout << "Registros encontrados en el rango de fechas:" << endl;
         for (int i = range.first; i <= range.second; ++i) {
-            cout << logs[i].date << " " << logs[i].time << " " << logs[i].ip << " - " << logs[i].message << endl;
+            writeEntry(cout, buffer, logs[i]);
+        }
+    }
+
+    if (queryOnly) {
+        // Histograma por hora del día obtenido directamente del índice
+        array<int, 24> counts = countByHourOfDay(index);
+        cout << "Registros por hora del día:" << endl;
+        for (int hour = 0; hour < 24; ++hour) {
+            cout << (hour < 10 ? "0" : "") << hour << ":00 " << counts[hour] << '\n';
         }
     }
 
@@ -234,8 +581,9 @@ int main() {
 
 /* Complejidades de los algoritmos utilizados:
  * - Carga del archivo (`loadLogFile`): O(n), donde n es la cantidad de líneas en el archivo.
- * - Quick Sort (`quickSort`): O(n log n) en promedio, O(n^2) en el peor caso.
- * - Búsqueda binaria (`binarySearchRange`): O(log n) para cada búsqueda.
+ * - Quick Sort (`quickSort`, núcleo `quickSortBy` de common/sort_kernels.h): O(n log n) en promedio.
+ * - Índice de tiempo (`buildTimeIndex`): O(n + H), con H = horas del año.
+ * - Búsqueda por rango (`searchRange`): O(log k) con búsqueda binaria dentro de la hora de cada límite.
  * - Escritura en el archivo (`writeLogsToFile`): O(n).
  * Complejidad total aproximada del programa: O(n log n).
  */
@@ -9,13 +9,15 @@
 
 // Incluir las librerías necesarias para el programa asi como el header
 #include "doubly_linked_list.h"
+#include "ip_trie.h"
+#include "../common/async_files.h"
 #include <iostream>
-#include <fstream>
 using namespace std;
 
 /*
  * Función principal del programa.
- * Carga un archivo de bitácora, ordena los registros por dirección IP, y permite buscar en un rango de IPs.
+ * Carga un archivo de bitácora, ordena los registros por dirección IP, y permite buscar en un rango de IPs
+ * y consultar subredes (a.b.c.d/prefijo) mediante el trie de prefijos.
  */
 int main() {
     DoublyLinkedList logs;
@@ -39,18 +41,46 @@ int main() {
     cout << "Ingrese la IP de fin: ";
     cin >> endIP;
 
-    // Crear archivo para el rango de búsqueda
-    ofstream rangeFile("range_output.txt");
-    if (!rangeFile.is_open()) {
-        cerr << "Error al abrir el archivo de salida para el rango." << endl;
+    // Guardar los registros en el rango especificado (printRange informa el error)
+    if (!logs.printRange(startIP, endIP, "range_output.txt")) {
         return 1;
     }
+    cout << "Registros en el rango guardados en: range_output.txt" << endl;
 
-    // Imprimir registros en el rango especificado
-    logs.printRange(startIP, endIP, rangeFile);
+    // Construir el índice de subredes sobre la lista ordenada
+    IPTrie trie;
+    trie.build(logs);
 
-    rangeFile.close();
-    cout << "Registros en el rango guardados en: range_output.txt" << endl;
+    cout << "Subredes /16 con más registros:" << endl;
+    for (const auto& subnet : trie.topSubnets(16, 5)) {
+        cout << subnet.first << " - Registros: " << subnet.second << endl;
+    }
+
+    // Solicitar una subred al usuario (opcional)
+    string subnet;
+    cout << "Ingrese una subred a consultar (a.b.c.d/prefijo): ";
+    if (cin >> subnet) {
+        SubnetRange range = trie.findSubnet(subnet);
+        if (range.count < 0) {
+            cerr << "Subred inválida; el prefijo debe ser 8, 16, 24 o 32." << endl;
+            return 1;
+        }
+
+        Node* current = range.first;
+        int remaining = range.count;
+        bool written = writeBlocksAsync("subnet_output.txt", [&](string& block, size_t limit) {
+            for (; remaining > 0 && block.size() < limit; --remaining, current = current->next) {
+                appendEntry(block, logs.getBuffer(), current->data);
+            }
+            return remaining > 0;
+        });
+        if (!written) {
+            cerr << "Error al abrir el archivo de salida para la subred." << endl;
+            return 1;
+        }
+        cout << "Subred " << subnet << ": " << range.count
+             << " registros guardados en: subnet_output.txt" << endl;
+    }
 
     return 0;
 }
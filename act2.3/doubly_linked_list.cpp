@@ -1,42 +1,72 @@
 // archivo de implementación de la lista doblemente enlazada
 #include "doubly_linked_list.h"
+#include "../common/async_files.h"
+#include "../common/log_tokenizer.h"
+#include "../common/parallel_loader.h"
+#include "../common/sort_kernels.h"
 #include <iostream>
-#include <fstream>
-#include <sstream>
-#include <unordered_map>
+#include <cctype>
+#include <cstring>
 using namespace std;
 
+// Tamaño del primer bloque de nodos
+const size_t FIRST_BLOCK_SIZE = 1024;
+
 /*
  * Constructor del nodo.
- * @param log Registro de bitácora a almacenar.
+ * @param log Registro de bitácora a almacenar (se mueve al nodo).
  */
-Node::Node(const LogEntry& log) : data(log), next(nullptr), prev(nullptr) {}
+Node::Node(LogEntry&& log) : data(move(log)), next(nullptr), prev(nullptr) {}
 
 /*
  * Constructor de la lista doblemente enlazada.
+ * Los nodos y el búfer se liberan junto con la lista (los bloques son unique_ptr).
  */
-DoublyLinkedList::DoublyLinkedList() : head(nullptr), tail(nullptr) {}
+DoublyLinkedList::DoublyLinkedList()
+    : head(nullptr), tail(nullptr), blockUsed(0), blockSize(0), nodeCapacity(0) {}
 
-/**
- * Destructor de la lista doblemente enlazada.
- * Libera la memoria ocupada por los nodos de la lista.
+/*
+ * Reserva de una vez un bloque para `count` nodos (por ejemplo, la cantidad estimada
+ * de registros de la carga), así que llenar la lista cuesta una sola reserva de memoria.
+ * Solo tiene efecto mientras la lista no tiene nodos.
+ * Complejidad: O(1) más la reserva.
+ * @param count Cantidad de nodos del bloque.
  */
-DoublyLinkedList::~DoublyLinkedList() {
-    Node* current = head;
-    while (current) {
-        Node* next = current->next;
-        delete current;
-        current = next;
+void DoublyLinkedList::reserve(size_t count) {
+    if (nodeCapacity > 0 || count == 0) return;
+    blocks.emplace_back(new Node[count]);
+    blockSize = nodeCapacity = count;
+    blockUsed = 0;
+}
+
+/*
+ * Toma un nodo libre de los bloques de la lista. Cuando el último bloque se llena (sin
+ * reserva, o si la lista rebasa la estimación) se agrega otro con tantos nodos como todos
+ * los anteriores, así que n nodos cuestan O(log n) reservas de memoria en lugar de una por
+ * nodo, y los nodos no se mueven de lugar.
+ * Complejidad: O(1) amortizado.
+ * @param log Registro de bitácora a almacenar (se mueve al nodo).
+ * @return Nodo con el registro, sin enlazar.
+ */
+Node* DoublyLinkedList::newNode(LogEntry&& log) {
+    if (blockUsed == blockSize) {
+        blockSize = max(FIRST_BLOCK_SIZE, nodeCapacity);
+        blocks.emplace_back(new Node[blockSize]);
+        nodeCapacity += blockSize;
+        blockUsed = 0;
     }
+    Node* node = &blocks.back()[blockUsed++];
+    *node = Node(move(log));
+    return node;
 }
 
 /*
  * Agrega un nuevo registro al final de la lista.
- * Complejidad: O(1).
- * @param log Registro de bitácora a agregar.
+ * Complejidad: O(1) amortizado.
+ * @param log Registro de bitácora a agregar (se mueve a la lista).
  */
-void DoublyLinkedList::append(const LogEntry& log) {
-    Node* newNode = new Node(log);
+void DoublyLinkedList::append(LogEntry&& log) {
+    Node* newNode = this->newNode(move(log));
     if (!head) {
         head = tail = newNode;
     } else {
@@ -46,151 +76,260 @@ void DoublyLinkedList::append(const LogEntry& log) {
     }
 }
 
-/*
- * Fusiona dos sublistas ordenadas.
- * Complejidad: O(n).
- * @param left Puntero al primer nodo de la sublista izquierda.
- * @param right Puntero al primer nodo de la sublista derecha.
- * @return Puntero al primer nodo de la lista fusionada.
- */
-Node* DoublyLinkedList::merge(Node* left, Node* right) {
-    if (!left) return right;
-    if (!right) return left;
-
-    if (left->data.ip <= right->data.ip) {
-        left->next = merge(left->next, right);
-        left->next->prev = left;
-        left->prev = nullptr;
-        return left;
-    } else {
-        right->next = merge(left, right->next);
-        right->next->prev = right;
-        right->prev = nullptr;
-        return right;
-    }
+/**
+ * Ordena la lista por dirección IP (numéricamente por octeto y después por puerto).
+ * Usa el merge sort iterativo de common/sort_kernels.h especializado para la clave de IP,
+ * así que no hay recursión por nodo ni riesgo de desbordar la pila con listas grandes.
+ * Complejidad: O(n log n).
+ */
+void DoublyLinkedList::sortByIP() {
+    head = mergeSortListBy<IPKey>(head);
+    tail = head;
+    while (tail && tail->next) tail = tail->next;
 }
 
 /*
- * Ordena una sublista utilizando merge sort.
- * Complejidad: O(n log n).
- * @param head Puntero al primer nodo de la sublista.
- * @return Puntero al primer nodo de la lista ordenada.
+ * Regresa el primer nodo de la lista.
+ * Complejidad: O(1).
+ * @return Puntero al primer nodo (nullptr si la lista está vacía).
  */
-Node* DoublyLinkedList::mergeSort(Node* head) {
-    if (!head || !head->next) return head;
-
-    Node* slow = head;
-    Node* fast = head->next;
-
-    while (fast && fast->next) {
-        slow = slow->next;
-        fast = fast->next->next;
-    }
-
-    Node* mid = slow->next;
-    slow->next = nullptr;
-    if (mid) mid->prev = nullptr;
-
-    Node* left = mergeSort(head);
-    Node* right = mergeSort(mid);
-
-    return merge(left, right);
+Node* DoublyLinkedList::getHead() const {
+    return head;
 }
 
-/**
- * Ordena la lista por dirección IP.
- * Complejidad: O(n log n).
+/*
+ * Regresa el búfer con el archivo cargado, al que hacen referencia los registros.
+ * Complejidad: O(1).
+ * @return Contenido del archivo.
  */
-void DoublyLinkedList::sortByIP() {
-    head = mergeSort(head);
-    tail = head;
-    while (tail && tail->next) tail = tail->next;
+const LargeString& DoublyLinkedList::getBuffer() const {
+    return buffer;
 }
 
 /*
  * Imprime los registros que están en un rango de IPs especificado.
+ * La comparación es numérica por octeto; si una IP no incluye puerto, el rango
+ * abarca todos sus puertos. Requiere que la lista esté ordenada con sortByIP.
+ * El archivo se escribe por bloques con writeBlocksAsync (asíncrona con C++20).
  * Complejidad: O(n).
  * @param startIP IP inicial del rango.
  * @param endIP IP final del rango.
- * @param outFile Archivo de salida donde se guardarán los registros.
+ * @param filename Archivo de salida donde se guardarán los registros.
+ * @return false (con el error en cerr) si alguna IP no es válida o el archivo no se pudo escribir.
  */
-void DoublyLinkedList::printRange(const string& startIP, const string& endIP, ofstream& outFile) {
-    Node* current = head;
-    bool found = false;
+bool DoublyLinkedList::printRange(const string& startIP, const string& endIP, const string& filename) {
+    unsigned long long startKey, endKey;
+    int startPort, endPort;
+    if (parseIPKey(startIP, startKey, startPort) < 0 || parseIPKey(endIP, endKey, endPort) < 0) {
+        cerr << "IP inválida en el rango: " << startIP << " - " << endIP << endl;
+        return false;
+    }
+    if (endPort < 0) {
+        endKey |= (1ULL << PORT_BITS) - 1; // Sin puerto: incluir todos los puertos
+    }
 
-    while (current) {
-        if (current->data.ip >= startIP && current->data.ip <= endIP) {
-            outFile << current->data.date << " " << current->data.time << " "
-                    << current->data.ip << " - " << current->data.message << endl;
-            found = true;
-        }
+    Node* current = head;
+    while (current && current->data.ipKey < startKey && current->data.ipKey <= endKey) {
         current = current->next;
     }
+    bool found = current && current->data.ipKey <= endKey;
 
-    if (!found) {
+    bool written = writeBlocksAsync(filename, [&](string& block, size_t limit) {
+        while (current && current->data.ipKey <= endKey && block.size() < limit) {
+            appendEntry(block, buffer, current->data);
+            current = current->next;
+        }
+        return current && current->data.ipKey <= endKey;
+    });
+
+    if (!written) {
+        cerr << "Error al abrir el archivo de salida para el rango." << endl;
+    } else if (!found) {
         cout << "No se encontraron registros en el rango especificado." << endl;
     }
+    return written;
 }
 
 /*
  * Imprime todos los registros en un archivo de salida.
+ * El archivo se escribe por bloques con writeBlocksAsync (asíncrona con C++20).
  * Complejidad: O(n).
  * @param filename Nombre del archivo de salida.
  */
 void DoublyLinkedList::printToFile(const string& filename) {
-    ofstream outFile(filename);
-    if (!outFile.is_open()) {
-        cerr << "Error al abrir el archivo de salida: " << filename << endl;
-        return;
-    }
-
     Node* current = head;
-    while (current) {
-        outFile << current->data.date << " " << current->data.time << " "
-                << current->data.ip << " - " << current->data.message << endl;
-        current = current->next;
+    bool written = writeBlocksAsync(filename, [&](string& block, size_t limit) {
+        while (current && block.size() < limit) {
+            appendEntry(block, buffer, current->data);
+            current = current->next;
+        }
+        return current != nullptr;
+    });
+    if (!written) {
+        cerr << "Error al escribir el archivo de salida: " << filename << endl;
     }
-    outFile.close();
 }
 
 /*
- * Carga los registros de la bitácora desde un archivo.
- * Complejidad: O(n), donde n es el número de líneas en el archivo.
- * @param filename Nombre del archivo de entrada.
- * @param list Lista doblemente enlazada donde se almacenarán los registros.
+ * Convierte una IP con formato "a.b.c.d" o "a.b.c.d:puerto" en su clave numérica.
+ * Complejidad: O(k), donde k es la longitud de la cadena.
+ * @param ipStr IP a convertir.
+ * @param key Clave resultante (los octetos y el puerto omitidos valen 0).
+ * @param port Puerto leído, o -1 si la cadena no lo incluye.
+ * @return Cantidad de octetos leídos, o -1 si algún octeto es mayor a lo que cabe en la clave.
  */
-void loadLogFile(const string& filename, DoublyLinkedList& list) {
-    ifstream file(filename);
-    if (!file.is_open()) {
-        cerr << "Error al abrir el archivo: " << filename << endl;
-        return;
+int parseIPKey(const string& ipStr, unsigned long long& key, int& port) {
+    key = 0;
+    port = -1;
+    int octets = 0;
+    size_t pos = 0;
+
+    while (octets < 4 && pos < ipStr.size() && isdigit(static_cast<unsigned char>(ipStr[pos]))) {
+        unsigned long long value = 0;
+        while (pos < ipStr.size() && isdigit(static_cast<unsigned char>(ipStr[pos]))) {
+            value = value * 10 + (ipStr[pos++] - '0');
+        }
+        if (value >= (1ULL << OCTET_BITS)) return -1;
+        key |= value << (PORT_BITS + OCTET_BITS * (3 - octets));
+        ++octets;
+        if (pos < ipStr.size() && ipStr[pos] == '.') ++pos;
     }
 
-    string line;
-    while (getline(file, line)) {
-        stringstream ss(line);
-        string month, day, time, ip, message;
+    if (pos < ipStr.size() && ipStr[pos] == ':') {
+        port = 0;
+        for (++pos; pos < ipStr.size() && isdigit(static_cast<unsigned char>(ipStr[pos])); ++pos) {
+            port = port * 10 + (ipStr[pos] - '0');
+        }
+        key |= static_cast<unsigned long long>(port) & ((1ULL << PORT_BITS) - 1);
+    }
+    return octets;
+}
+
+/*
+ * Obtiene un octeto de una clave numérica de IP.
+ * Complejidad: O(1).
+ * @param key Clave numérica de la IP.
+ * @param level Posición del octeto (0 = primero).
+ * @return Valor del octeto.
+ */
+int octetOf(unsigned long long key, int level) {
+    return (key >> (PORT_BITS + OCTET_BITS * (3 - level))) & ((1ULL << OCTET_BITS) - 1);
+}
+
+/*
+ * Escribe un registro con el formato "fecha hora IP - mensaje".
+ * Complejidad: O(k), donde k es la longitud del registro.
+ * @param out Flujo de salida.
+ * @param buffer Búfer con el contenido del archivo.
+ * @param log Registro a escribir.
+ */
+void writeEntry(ostream& out, const LargeString& buffer, const LogEntry& log) {
+    out.write(log.date, sizeof(log.date));
+    out << ' ';
+    out.write(log.time, sizeof(log.time));
+    out << ' ';
+    out.write(buffer.data() + log.ip.offset, log.ip.length);
+    out << " - ";
+    out.write(buffer.data() + log.message.offset, log.message.length);
+    out << '\n';
+}
+
+/*
+ * Agrega un registro con el formato de writeEntry al final de un bloque de texto.
+ * Complejidad: O(k), donde k es la longitud del registro.
+ * @param out Bloque de texto.
+ * @param buffer Búfer con el contenido del archivo.
+ * @param log Registro a agregar.
+ */
+void appendEntry(string& out, const LargeString& buffer, const LogEntry& log) {
+    out.append(log.date, sizeof(log.date));
+    out += ' ';
+    out.append(log.time, sizeof(log.time));
+    out += ' ';
+    out.append(buffer.data() + log.ip.offset, log.ip.length);
+    out.append(" - ");
+    out.append(buffer.data() + log.message.offset, log.message.length);
+    out += '\n';
+}
 
-        // Leer componentes de la línea
-        ss >> month >> day >> time >> ip;
-        getline(ss, message);
+/*
+ * Copia un campo de texto a un campo fijo del registro, completando con ceros a la
+ * izquierda si es más corto (por ejemplo, el día "5") y recortándolo si es más largo.
+ * Complejidad: O(m), donde m es el tamaño del campo.
+ * @param field Campo fijo del registro.
+ * @param size Tamaño del campo.
+ * @param text Texto a copiar.
+ * @param length Longitud del texto.
+ */
+void copyField(char* field, size_t size, const char* text, size_t length) {
+    size_t padding = length < size ? size - length : 0;
+    memset(field, '0', padding);
+    memcpy(field + padding, text, size - padding);
+}
 
-        // Convertir mes a número
-        string monthNumber;
-        unordered_map<string, string> monthMap = {
-            {"Jan", "01"}, {"Feb", "02"}, {"Mar", "03"}, {"Apr", "04"},
-            {"May", "05"}, {"Jun", "06"}, {"Jul", "07"}, {"Aug", "08"},
-            {"Sep", "09"}, {"Oct", "10"}, {"Nov", "11"}, {"Dec", "12"}};
-        monthNumber = monthMap[month];
+/*
+ * Interpreta una línea de la bitácora ("Mes día hh:mm:ss IP mensaje").
+ * Complejidad: O(k), donde k es la longitud de la línea.
+ * @param buffer Búfer con el contenido del archivo.
+ * @param lineStart Posición del inicio de la línea.
+ * @param lineEnd Posición del fin de la línea (sin el salto de línea).
+ * @param log Registro donde se almacenará el resultado.
+ * @return false si la línea está vacía o incompleta.
+ */
+bool parseLogLine(const LargeString& buffer, size_t lineStart, size_t lineEnd, LogEntry& log) {
+    // Leer componentes de la línea (segmentos del búfer, sin copiarlos)
+    LineTokens tokens;
+    if (!tokenizeLine(buffer.data() + lineStart, lineEnd - lineStart, tokens)) return false;
+    Span fields[4];
+    for (int i = 0; i < 4; ++i) {
+        fields[i] = {lineStart + tokens.start[i], tokens.end[i] - tokens.start[i]};
+    }
+    Span month = fields[0];
+    Span day = fields[1];
+    Span time = fields[2];
+    const char* text = buffer.data();
 
-        if (day.back() == ',') day.pop_back();
-        if (stoi(day) < 10) day = "0" + day;
+    // Convertir mes a número ("00" si el mes no es válido) y el día a dos dígitos
+    memcpy(log.date, MONTH_NUMBERS[monthFromName(text + month.offset, month.length)], 2);
+    log.date[2] = '-';
+    if (text[day.offset + day.length - 1] == ',') day.length--;
+    copyField(log.date + 3, 2, text + day.offset, day.length);
+    copyField(log.time, sizeof(log.time), text + time.offset, time.length);
 
-        string date = monthNumber + "-" + day;
+    log.ip = fields[3];
+    log.message = {lineStart + tokens.rest, lineEnd - lineStart - tokens.rest};
 
-        // Agregar registro a la lista
-        list.append({date, time, ip, message});
+    // Clave numérica para ordenar y consultar por subred
+    int octets[4], port;
+    parseIPPort(text + log.ip.offset, text + lineEnd, octets, port);
+    log.ipKey = 0;
+    for (int octet = 0; octet < 4; ++octet) {
+        log.ipKey |= static_cast<unsigned long long>(octets[octet] & ((1 << OCTET_BITS) - 1))
+                     << (PORT_BITS + OCTET_BITS * (3 - octet));
     }
+    log.ipKey |= port & ((1ULL << PORT_BITS) - 1);
+    return true;
+}
 
-    file.close();
+/*
+ * Carga los registros de la bitácora desde un archivo.
+ * La lectura e interpretación se hacen en paralelo con loadParallelAsync (lecturas
+ * asíncronas si se compiló con C++20, ver common/async_files.h) y los registros
+ * se mueven a la lista en el orden del archivo. El archivo queda en el búfer de la lista.
+ * Los nodos se reservan de una vez con la cantidad estimada a partir del primer lote.
+ * Complejidad: O(n), donde n es el número de líneas en el archivo.
+ * @param filename Nombre del archivo de entrada.
+ * @param list Lista doblemente enlazada donde se almacenarán los registros.
+ * @param threads, chunkSize Hilos y tamaño de segmento del pipeline (igual que en loadParallel).
+ */
+void loadLogFile(const string& filename, DoublyLinkedList& list, unsigned threads, size_t chunkSize) {
+    bool opened = loadParallelAsync<LogEntry>(filename, list.buffer, parseLogLine, [&list](vector<LogEntry>&& batch) {
+        list.reserve(estimateRecordCount(batch, list.buffer.size())); // Solo con el primer lote
+        for (LogEntry& log : batch) {
+            list.append(move(log));
+        }
+    }, threads, chunkSize);
+    if (!opened) {
+        cerr << "Error al abrir el archivo: " << filename << endl;
+    }
 }
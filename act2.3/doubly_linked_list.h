@@ -2,14 +2,41 @@
 #ifndef DOUBLY_LINKED_LIST_H
 #define DOUBLY_LINKED_LIST_H
 
+#include <cstddef>
+#include <iosfwd>
+#include <memory>
 #include <string>
+#include <vector>
+
+#include "../common/large_pages.h"
 using namespace std;
 
+// Cantidad de bits por octeto en la clave numérica. Las bitácoras contienen octetos
+// mayores a 255, por lo que cada octeto ocupa 10 bits (0-1023) y el puerto 16 bits.
+const int OCTET_BITS = 10;
+const int PORT_BITS = 16;
+
+// Segmento (posición, longitud) dentro del búfer con el archivo de entrada
+struct Span {
+    size_t offset;
+    size_t length;
+};
+
+// Registro de bitácora con campos de tamaño fijo: la fecha y la hora van dentro del
+// registro y la IP y el mensaje son segmentos del búfer de la lista, así que un registro
+// nunca reserva memoria. Solo se puede mover, para que no se copie por accidente.
 struct LogEntry {
-    string date;
-    string time;
-    string ip;
-    string message;
+    char date[5]; // "MM-DD"
+    char time[8]; // "hh:mm:ss"
+    Span ip;
+    Span message;
+    unsigned long long ipKey; // Clave numérica de la IP y el puerto para ordenar
+
+    LogEntry() = default;
+    LogEntry(LogEntry&&) = default;
+    LogEntry& operator=(LogEntry&&) = default;
+    LogEntry(const LogEntry&) = delete;
+    LogEntry& operator=(const LogEntry&) = delete;
 };
 
 struct Node {
@@ -17,26 +44,42 @@ struct Node {
     Node* next;
     Node* prev;
 
-    Node(const LogEntry& log);
+    Node() = default;
+    explicit Node(LogEntry&& log);
 };
 
 class DoublyLinkedList {
 private:
     Node* head;
     Node* tail;
-    Node* mergeSort(Node* head);
-    Node* merge(Node* left, Node* right);
+    LargeString buffer;                // Contenido del archivo (los registros guardan segmentos)
+    vector<unique_ptr<Node[]>> blocks; // Bloques de nodos (el primero, del tamaño estimado)
+    size_t blockUsed;                  // Nodos ocupados del último bloque
+    size_t blockSize;                  // Tamaño del último bloque
+    size_t nodeCapacity;               // Nodos de todos los bloques
+
+    Node* newNode(LogEntry&& log);
 
 public:
     DoublyLinkedList();
-    ~DoublyLinkedList();
+    DoublyLinkedList(const DoublyLinkedList&) = delete;
+    DoublyLinkedList& operator=(const DoublyLinkedList&) = delete;
 
-    void append(const LogEntry& log);
+    void reserve(size_t count);
+    void append(LogEntry&& log);
     void sortByIP();
-    void printRange(const string& startIP, const string& endIP, ofstream& outFile);
+    bool printRange(const string& startIP, const string& endIP, const string& filename);
     void printToFile(const string& filename);
+    Node* getHead() const;
+    const LargeString& getBuffer() const;
+
+    friend void loadLogFile(const string& filename, DoublyLinkedList& list, unsigned threads, size_t chunkSize);
 };
 
-void loadLogFile(const string& filename, DoublyLinkedList& list);
+int parseIPKey(const string& ipStr, unsigned long long& key, int& port);
+int octetOf(unsigned long long key, int level);
+void writeEntry(ostream& out, const LargeString& buffer, const LogEntry& log);
+void appendEntry(string& out, const LargeString& buffer, const LogEntry& log);
+void loadLogFile(const string& filename, DoublyLinkedList& list, unsigned threads = 0, size_t chunkSize = 4 << 20);
 
 #endif
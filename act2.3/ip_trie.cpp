@@ -0,0 +1,128 @@
+// archivo de implementación del índice de subredes
+#include "ip_trie.h"
+#include <algorithm>
+#include <cstdio>
+using namespace std;
+
+/*
+ * Construye el trie a partir de una lista ordenada por IP.
+ * Como la lista está ordenada, cada subred es un bloque contiguo de registros y
+ * basta un solo recorrido para crear los nodos y sus conteos.
+ * Complejidad: O(n), donde n es el número de registros.
+ * @param list Lista ordenada con sortByIP.
+ */
+void IPTrie::build(const DoublyLinkedList& list) {
+    for (auto& level : levels) level.clear();
+
+    for (Node* current = list.getHead(); current; current = current->next) {
+        unsigned long long key = current->data.ipKey;
+
+        // Buscar el primer nivel donde el registro sale de la subred actual
+        int level = 0;
+        while (level < 4 && !levels[level].empty() && levels[level].back().octet == octetOf(key, level)) {
+            ++level;
+        }
+
+        // Crear los nodos de las subredes nuevas
+        for (int l = level; l < 4; ++l) {
+            int parent = l == 0 ? -1 : levels[l - 1].size() - 1;
+            int next = l < 3 ? levels[l + 1].size() : 0;
+            levels[l].push_back({octetOf(key, l), parent, next, next, current, 0});
+            if (parent >= 0) levels[l - 1][parent].childEnd = levels[l].size();
+        }
+
+        for (int l = 0; l < 4; ++l) levels[l].back().count++;
+    }
+}
+
+/*
+ * Busca un octeto entre los nodos [begin, end) de un nivel.
+ * Complejidad: O(log k), donde k es la cantidad de hermanos.
+ * @return Índice del nodo, o -1 si no existe.
+ */
+int IPTrie::find(int level, int begin, int end, int octet) const {
+    auto first = levels[level].begin() + begin;
+    auto last = levels[level].begin() + end;
+    auto it = lower_bound(first, last, octet,
+                          [](const SubnetNode& node, int value) { return node.octet < value; });
+    if (it == last || it->octet != octet) return -1;
+    return it - levels[level].begin();
+}
+
+/*
+ * Obtiene los registros de una subred con formato "a.b.c.d/prefijo".
+ * El prefijo debe ser múltiplo de 8 (8, 16, 24 o 32), ya que los octetos de la
+ * bitácora pueden ser mayores a 255 y el trie se ramifica por octeto.
+ * Complejidad: O(p log k), donde p es la cantidad de octetos del prefijo.
+ * @param cidr Subred a consultar.
+ * @return Primer registro y cantidad de registros de la subred (count = -1 si el formato es inválido).
+ */
+SubnetRange IPTrie::findSubnet(const string& cidr) const {
+    size_t slash = cidr.find('/');
+    int prefixLength = 32;
+    if (slash != string::npos && sscanf(cidr.c_str() + slash + 1, "%d", &prefixLength) != 1) {
+        return {nullptr, -1};
+    }
+    if (prefixLength < 0 || prefixLength > 32 || prefixLength % 8 != 0) {
+        return {nullptr, -1};
+    }
+
+    unsigned long long key;
+    int port;
+    if (parseIPKey(cidr.substr(0, slash), key, port) < 0) {
+        return {nullptr, -1};
+    }
+
+    int octets = prefixLength / 8;
+    if (octets == 0) {
+        int total = 0;
+        for (const SubnetNode& node : levels[0]) total += node.count;
+        return {levels[0].empty() ? nullptr : levels[0].front().first, total};
+    }
+
+    int begin = 0, end = levels[0].size(), index = -1;
+    for (int level = 0; level < octets; ++level) {
+        index = find(level, begin, end, octetOf(key, level));
+        if (index < 0) return {nullptr, 0};
+        begin = levels[level][index].childBegin;
+        end = levels[level][index].childEnd;
+    }
+    const SubnetNode& node = levels[octets - 1][index];
+    return {node.first, node.count};
+}
+
+/*
+ * Obtiene las k subredes con más registros para un prefijo dado.
+ * Complejidad: O(m log k), donde m es la cantidad de subredes del nivel.
+ * @param prefixLength Longitud del prefijo (8, 16, 24 o 32).
+ * @param k Cantidad de subredes a regresar.
+ * @return Pares (subred en formato CIDR, cantidad de registros) de mayor a menor.
+ */
+vector<pair<string, int>> IPTrie::topSubnets(int prefixLength, int k) const {
+    vector<pair<string, int>> result;
+    if (prefixLength < 8 || prefixLength > 32 || prefixLength % 8 != 0) return result;
+
+    int level = prefixLength / 8 - 1;
+    vector<int> order(levels[level].size());
+    for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+
+    int top = min<int>(k, order.size());
+    partial_sort(order.begin(), order.begin() + top, order.end(), [&](int a, int b) {
+        if (levels[level][a].count != levels[level][b].count) {
+            return levels[level][a].count > levels[level][b].count;
+        }
+        return a < b;
+    });
+
+    for (int i = 0; i < top; ++i) {
+        // Reconstruir los octetos recorriendo los padres
+        int octets[4] = {0, 0, 0, 0};
+        for (int l = level, index = order[i]; l >= 0; index = levels[l][index].parent, --l) {
+            octets[l] = levels[l][index].octet;
+        }
+        string subnet = to_string(octets[0]) + "." + to_string(octets[1]) + "." +
+                        to_string(octets[2]) + "." + to_string(octets[3]) + "/" + to_string(prefixLength);
+        result.push_back({subnet, levels[level][order[i]].count});
+    }
+    return result;
+}
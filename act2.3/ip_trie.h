@@ -0,0 +1,39 @@
+// Header para el índice de subredes (trie de prefijos por octeto)
+#ifndef IP_TRIE_H
+#define IP_TRIE_H
+
+#include "doubly_linked_list.h"
+#include <string>
+#include <vector>
+using namespace std;
+
+// Nodo del trie: representa una subred con un prefijo de 1 a 4 octetos.
+// Los nodos de cada nivel se guardan contiguos y ordenados por octeto, y los hijos
+// de un nodo ocupan el rango [childBegin, childEnd) del siguiente nivel.
+struct SubnetNode {
+    int octet;       // Valor del octeto en este nivel
+    int parent;      // Índice del padre en el nivel anterior (-1 en el primer nivel)
+    int childBegin;  // Primer hijo en el siguiente nivel
+    int childEnd;    // Uno después del último hijo
+    Node* first;     // Primer registro de la subred en la lista ordenada
+    int count;       // Cantidad de registros de la subred
+};
+
+// Resultado de una consulta de subred: registros contiguos de la lista ordenada.
+struct SubnetRange {
+    Node* first;
+    int count;
+};
+
+class IPTrie {
+private:
+    vector<SubnetNode> levels[4];
+    int find(int level, int begin, int end, int octet) const;
+
+public:
+    void build(const DoublyLinkedList& list);
+    SubnetRange findSubnet(const string& cidr) const;
+    vector<pair<string, int>> topSubnets(int prefixLength, int k) const;
+};
+
+#endif
@@ -1,13 +1,16 @@
 /**
  * Corrrección de ordenamiento de ips en bitácora
+ * Compilación (con C++17 la carga y la escritura son bloqueantes):
+ *   g++ -std=c++20 -O2 -pthread act2.3.2.cpp -o act2.3.2
  */
 
 
 #include <iostream>
-#include <fstream>
-#include <sstream>
 #include <string>
 #include <unordered_map>
+#include "../common/async_files.h"
+#include "../common/log_tokenizer.h"
+#include "../common/sort_kernels.h"
 using namespace std;
 
 // Estructura para almacenar un registro de bitácora
@@ -16,6 +19,7 @@ struct LogEntry {
     string time;
     string ip;
     string message;
+    unsigned long long ipKey; // Octetos de 10 bits y puerto de 16 bits, en el orden de (ip1, ..., ip4, puerto)
 };
 
 // Nodo para la lista doblemente enlazada
@@ -23,7 +27,7 @@ struct Node {
     LogEntry data;
     Node* next;
     Node* prev;
-    Node(const LogEntry& log) : data(log), next(nullptr), prev(nullptr) {}
+    Node(LogEntry&& log) : data(move(log)), next(nullptr), prev(nullptr) {}
 };
 
 // Clase para la lista doblemente enlazada
@@ -31,16 +35,14 @@ class DoublyLinkedList {
 private:
     Node* head;
     Node* tail;
-    Node* mergeSort(Node* head);
-    Node* merge(Node* left, Node* right);
 
 public:
     DoublyLinkedList() : head(nullptr), tail(nullptr) {}
     ~DoublyLinkedList();
 
-    void append(const LogEntry& log);
+    void append(LogEntry&& log);
     void sortByIP();
-    void printRange(const string& startIP, const string& endIP, ofstream& outFile);
+    bool printRange(const string& startIP, const string& endIP, const string& filename);
     void printToFile(const string& filename);
 };
 
@@ -53,8 +55,9 @@ DoublyLinkedList::~DoublyLinkedList() {
     }
 }
 
-void DoublyLinkedList::append(const LogEntry& log) {
-    Node* newNode = new Node(log);
+// El registro se mueve al nodo: sus cadenas no se copian
+void DoublyLinkedList::append(LogEntry&& log) {
+    Node* newNode = new Node(move(log));
     if (!head) {
         head = tail = newNode;
     } else {
@@ -64,103 +67,92 @@ void DoublyLinkedList::append(const LogEntry& log) {
     }
 }
 
-void DoublyLinkedList::printToFile(const string& filename) {
-    ofstream outFile(filename);
-    if (!outFile.is_open()) {
-        cerr << "Error al abrir el archivo de salida: " << filename << endl;
-        return;
-    }
+void appendEntry(string& out, const LogEntry& log) {
+    out += log.date;
+    out += ' ';
+    out += log.time;
+    out += ' ';
+    out += log.ip;
+    out += " - ";
+    out += log.message;
+    out += '\n';
+}
 
+// Los archivos se escriben por bloques con writeBlocksAsync (asíncrona con C++20)
+void DoublyLinkedList::printToFile(const string& filename) {
     Node* current = head;
-    while (current) {
-        outFile << current->data.date << " " << current->data.time << " "
-                << current->data.ip << " - " << current->data.message << endl;
-        current = current->next;
+    bool written = writeBlocksAsync(filename, [&](string& block, size_t limit) {
+        while (current && block.size() < limit) {
+            appendEntry(block, current->data);
+            current = current->next;
+        }
+        return current != nullptr;
+    });
+    if (!written) {
+        cerr << "Error al abrir el archivo de salida: " << filename << endl;
     }
-    outFile.close();
 }
 
-void DoublyLinkedList::printRange(const string& startIP, const string& endIP, ofstream& outFile) {
+bool DoublyLinkedList::printRange(const string& startIP, const string& endIP, const string& filename) {
     Node* current = head;
-    while (current) {
-        if (current->data.ip >= startIP && current->data.ip <= endIP) {
-            outFile << current->data.date << " " << current->data.time << " "
-                    << current->data.ip << " - " << current->data.message << endl;
+    return writeBlocksAsync(filename, [&](string& block, size_t limit) {
+        for (; current && block.size() < limit; current = current->next) {
+            if (current->data.ip >= startIP && current->data.ip <= endIP) {
+                appendEntry(block, current->data);
+            }
         }
-        current = current->next;
-    }
+        return current != nullptr;
+    });
 }
 
 void parseIP(const string& ipStr, int& ip1, int& ip2, int& ip3, int& ip4, int& port) {
     sscanf(ipStr.c_str(), "%d.%d.%d.%d:%d", &ip1, &ip2, &ip3, &ip4, &port);
 }
 
-Node* DoublyLinkedList::merge(Node* left, Node* right) {
-    if (!left) return right;
-    if (!right) return left;
-
-    int leftIP1, leftIP2, leftIP3, leftIP4, leftPort;
-    int rightIP1, rightIP2, rightIP3, rightIP4, rightPort;
-
-    parseIP(left->data.ip, leftIP1, leftIP2, leftIP3, leftIP4, leftPort);
-    parseIP(right->data.ip, rightIP1, rightIP2, rightIP3, rightIP4, rightPort);
-
-    if (tie(leftIP1, leftIP2, leftIP3, leftIP4, leftPort) <= tie(rightIP1, rightIP2, rightIP3, rightIP4, rightPort)) {
-        left->next = merge(left->next, right);
-        left->next->prev = left;
-        left->prev = nullptr;
-        return left;
-    } else {
-        right->next = merge(left, right->next);
-        right->next->prev = right;
-        right->prev = nullptr;
-        return right;
-    }
-}
-
-Node* DoublyLinkedList::mergeSort(Node* head) {
-    if (!head || !head->next) return head;
-
-    Node* slow = head;
-    Node* fast = head->next;
-
-    while (fast && fast->next) {
-        slow = slow->next;
-        fast = fast->next->next;
-    }
-
-    Node* mid = slow->next;
-    slow->next = nullptr;
-    if (mid) mid->prev = nullptr;
-
-    Node* left = mergeSort(head);
-    Node* right = mergeSort(mid);
-
-    return merge(left, right);
+unsigned long long ipKeyOf(const string& ipStr) {
+    int ip1 = 0, ip2 = 0, ip3 = 0, ip4 = 0, port = 0;
+    parseIP(ipStr, ip1, ip2, ip3, ip4, port);
+    unsigned long long key = 0;
+    for (int octet : {ip1, ip2, ip3, ip4}) key = (key << 10) | (octet & 1023);
+    return (key << 16) | (port & 0xFFFF);
 }
 
+// La clave de cada registro se calcula una vez al cargarlo; el merge sort (iterativo, de
+// common/sort_kernels.h) solo compara enteros en lugar de llamar a sscanf en cada comparación.
 void DoublyLinkedList::sortByIP() {
-    head = mergeSort(head);
+    head = mergeSortListBy<IPKey>(head);
     tail = head;
     while (tail && tail->next) tail = tail->next;
 }
 
-void loadLogFile(const string& filename, DoublyLinkedList& list) {
-    ifstream file(filename);
-    if (!file.is_open()) {
-        cerr << "Error al abrir el archivo: " << filename << endl;
-        return;
+// Campos de la línea como con `>>`: el mensaje incluye el espacio que lo separa de la IP
+bool parseLogLine(const LargeString& buffer, size_t lineStart, size_t lineEnd, LogEntry& log) {
+    const char* line = buffer.data() + lineStart;
+    LineTokens tokens;
+    tokenizeLine(line, lineEnd - lineStart, tokens);
+    string fields[4];
+    for (int i = 0; i < tokens.count; ++i) {
+        fields[i].assign(line + tokens.start[i], tokens.end[i] - tokens.start[i]);
     }
+    log.date = fields[0] + "-" + fields[1];
+    log.time = move(fields[2]);
+    log.ip = move(fields[3]);
+    log.message.assign(line + tokens.rest, lineEnd - lineStart - tokens.rest);
+    log.ipKey = ipKeyOf(log.ip);
+    return true;
+}
 
-    string line;
-    while (getline(file, line)) {
-        stringstream ss(line);
-        string month, day, time, ip, message;
-        ss >> month >> day >> time >> ip;
-        getline(ss, message);
-        list.append({month + "-" + day, time, ip, message});
+// El archivo se carga con el pipeline de loadParallelAsync (lecturas asíncronas con C++20)
+void loadLogFile(const string& filename, DoublyLinkedList& list) {
+    LargeString buffer;
+    bool opened = loadParallelAsync<LogEntry>(filename, buffer, parseLogLine, [&list](vector<LogEntry>&& batch) {
+        for (LogEntry& log : batch) {
+            list.append(move(log));
+        }
+    });
+    if (!opened) {
+        cerr << "Error al abrir el archivo: " << filename << endl;
     }
-    file.close();
 }
 
 int main() {
@@ -182,13 +174,10 @@ int main() {
     cin >> endIP;
 
     // Guardar registros dentro del rango en un archivo
-    ofstream rangeFile(rangeOutputFile);
-    if (!rangeFile.is_open()) {
+    if (!logs.printRange(startIP, endIP, rangeOutputFile)) {
         cerr << "Error al abrir el archivo de salida para el rango." << endl;
         return 1;
     }
-    logs.printRange(startIP, endIP, rangeFile);
-    rangeFile.close();
 
     cout << "Registros en el rango guardados en: " << rangeOutputFile << endl;
     return 0;
@@ -12,12 +12,13 @@
 // Inclusión de bibliotecas necesarias
 #include <iostream>
 #include <fstream>
-#include <sstream>
 #include <string>
 #include <map>
 #include <set>
 #include <vector>
-#include <cstdio> // Para sscanf
+
+#include "../common/log_tokenizer.h"
+#include "../common/parallel_loader.h"
 
 using namespace std;
 
@@ -28,8 +29,13 @@ using namespace std;
  * 
  * @complejidad O(1), ya que la operación de extracción siempre se realiza en tiempo constante.
  */
-void parseIP(const string& ipStr, int& ip1, int& ip2, int& ip3, int& ip4, int& port) {
-    sscanf(ipStr.c_str(), "%d.%d.%d.%d:%d", &ip1, &ip2, &ip3, &ip4, &port);
+void parseIP(const char* ipStr, const char* end, int& ip1, int& ip2, int& ip3, int& ip4, int& port) {
+    int octets[4];
+    parseIPPort(ipStr, end, octets, port); // Decodificación SWAR de common/log_tokenizer.h
+    ip1 = octets[0];
+    ip2 = octets[1];
+    ip3 = octets[2];
+    ip4 = octets[3];
 }
 
 /**
@@ -124,35 +130,34 @@ public:
  * @return int Código de salida del programa (0 = éxito, 1 = error).
  */
 int main() {
-    // Abrir el archivo de entrada
-    ifstream file("sorted_by_ip_modificado.txt");
-    if (!file) {
-        cerr << "Error al abrir el archivo" << endl;
-        return 1;
-    }
-
     map<string, int> ipCount; ///< Mapa para contar accesos por IP
-    string line;
+    LargeString buffer;       ///< Contenido del archivo de entrada
 
-    // Leer línea por línea el archivo
-    while (getline(file, line)) {
-        stringstream ss(line);
-        string date, time, ipPort, message;
-        ss >> date >> time >> ipPort; // Se extraen los primeros tres elementos
-        getline(ss, message); // Se ignora el mensaje de la bitácora
+    // Leer e interpretar el archivo en paralelo; los lotes se cuentan en el hilo principal
+    auto parseLine = [](const LargeString& buffer, size_t lineStart, size_t lineEnd, string& ip) {
+        // Se extraen los primeros tres elementos; se ignora el mensaje de la bitácora
+        LineTokens tokens;
+        tokenizeLine(buffer.data() + lineStart, lineEnd - lineStart, tokens);
+        if (tokens.count < 3) return false;
 
         // Extraer la IP sin el puerto
         int ip1, ip2, ip3, ip4, port;
-        parseIP(ipPort, ip1, ip2, ip3, ip4, port);
+        parseIP(buffer.data() + lineStart + tokens.start[2], buffer.data() + lineEnd, ip1, ip2, ip3, ip4, port);
 
         // Convertir la IP a una cadena estandarizada
-        string ip = to_string(ip1) + "." + to_string(ip2) + "." + to_string(ip3) + "." + to_string(ip4);
-        
-        ipCount[ip]++; // Incrementar el contador de accesos para la IP
+        ip = to_string(ip1) + "." + to_string(ip2) + "." + to_string(ip3) + "." + to_string(ip4);
+        return true;
+    };
+    bool opened = loadParallel<string>("sorted_by_ip_modificado.txt", buffer, parseLine, [&](vector<string>&& ips) {
+        for (const string& ip : ips) {
+            ipCount[ip]++; // Incrementar el contador de accesos para la IP
+        }
+    });
+    if (!opened) {
+        cerr << "Error al abrir el archivo" << endl;
+        return 1;
     }
 
-    file.close(); // Cerrar el archivo
-
     // Insertar las IPs en el árbol BST
     BST bst;
     for (const auto& entry : ipCount) {
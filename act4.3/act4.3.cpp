@@ -17,115 +17,236 @@
 #include <set>
 #include <vector>
 #include <algorithm>
+#include <string_view>
+#include <cmath>
+#include <cctype>
+#include <cstdlib>
+
+#include "../common/async_files.h"
+#include "../common/log_tokenizer.h"
+#include "../common/parallel_loader.h"
+#include "../common/hyperloglog.h"
+#include "../common/attack_graph.h"
+#include "../common/attack_graph_file.h"
 
 using namespace std;
 
-// Estructura para almacenar un intento de acceso de la bitácora
+// Segmento (posición, longitud) dentro del búfer con el archivo de entrada
+struct Span {
+    size_t offset;
+    size_t length;
+};
+
+// Estructura para almacenar un intento de acceso de la bitácora.
+// Los campos de texto no se copian: se guardan como segmentos del búfer de entrada
+// y solo se decodifican cuando el registro se imprime.
 struct LogEntry {
-    string date;
-    string time;
-    string ip;
+    Span month;
+    Span day;
+    Span time;
+    Span ip;
     int port;
-    string message;
+    Span message;
+    unsigned long long ipKey; // IP y puerto como clave numérica (octetos de 10 bits y puerto de 16 bits)
+};
+
+/*
+    Estructura: PortFanIn
+    Descripción: Atacantes distintos ("IP:puerto") por puerto. En el modo exacto se construye el grafo
+        puerto -> atacantes en formato CSR (common/attack_graph.h) en paralelo después de la carga; en el
+        modo aproximado solo se guarda un HyperLogLog por puerto (common/hyperloglog.h), que ocupa a lo más
+        2^precision bytes sin importar cuántos atacantes haya.
+*/
+struct PortFanIn {
+    int precision; // 0 para el modo exacto
+    AttackGraph graph;
+    map<int, HyperLogLog> sketches;
+
+    // Agrega un atacante en el modo aproximado (el modo exacto usa el grafo)
+    void add(int port, string_view ip) {
+        sketches.emplace(port, HyperLogLog(precision)).first->second.add(ip.data(), ip.size());
+    }
+
+    // Cantidad (exacta o estimada) de atacantes distintos de cada puerto
+    map<int, double> counts() const {
+        map<int, double> result;
+        for (size_t i = 0; i < graph.ports.size(); ++i) result[graph.ports[i]] = graph.fanOut(i);
+        for (const auto& entry : sketches) result[entry.first] = entry.second.estimate();
+        return result;
+    }
 };
 
 /*
     Función: parseIP
     Descripción: Extrae la dirección IP y el número de puerto desde una cadena con formato "IP:Puerto".
+        Los números se decodifican con SWAR (ver common/log_tokenizer.h).
     Parámetros:
-        - ipStr (string): Dirección IP con puerto adjunto.
+        - ipStr (const char*): Dirección IP con puerto adjunto (no requiere terminar en '\0').
+        - end (const char*): Límite de lectura (por ejemplo, el fin de la línea).
         - ip1, ip2, ip3, ip4 (int&): Variables para almacenar los segmentos de la IP.
         - port (int&): Variable para almacenar el puerto extraído.
     Retorno:
         - Ninguno.
 */
-void parseIP(const string& ipStr, int& ip1, int& ip2, int& ip3, int& ip4, int& port) {
-    sscanf(ipStr.c_str(), "%d.%d.%d.%d:%d", &ip1, &ip2, &ip3, &ip4, &port);
+void parseIP(const char* ipStr, const char* end, int& ip1, int& ip2, int& ip3, int& ip4, int& port) {
+    int octets[4];
+    parseIPPort(ipStr, end, octets, port);
+    ip1 = octets[0];
+    ip2 = octets[1];
+    ip3 = octets[2];
+    ip4 = octets[3];
 }
 
 /*
     Función: extractHour
     Descripción: Extrae la hora de un formato "hh:mm:ss".
     Parámetros:
-        - time (string): Hora en formato de cadena "hh:mm:ss".
+        - time (const char*): Hora en formato "hh:mm:ss" (no requiere terminar en '\0').
+        - length (size_t): Longitud del texto de la hora.
     Retorno:
         - (int): La hora en formato entero.
 */
-int extractHour(const string& time) {
-    stringstream ss(time);
-    int hour, minute, second;
-    char separator;
-    ss >> hour >> separator >> minute >> separator >> second;
+int extractHour(const char* time, size_t length) {
+    int hour = 0, minute = 0, second = 0;
+    parseClock(time, length, hour, minute, second);
     return hour;
 }
 
+/*
+    Función: view
+    Descripción: Devuelve la vista de texto de un segmento del búfer sin copiarlo.
+    Parámetros:
+        - buffer (const LargeString&): Búfer con el contenido del archivo.
+        - span (Span): Segmento a consultar.
+    Retorno:
+        - (string_view): Texto del segmento.
+*/
+string_view view(const LargeString& buffer, Span span) {
+    return string_view(buffer.data() + span.offset, span.length);
+}
+
+/*
+    Función: parseLogLine
+    Descripción: Interpreta una línea de la bitácora y la conserva solo si el intento ocurrió
+        en un horario sospechoso (00:00 - 05:00).
+    Parámetros:
+        - buffer (const LargeString&): Búfer con el contenido del archivo.
+        - lineStart (size_t): Posición del inicio de la línea.
+        - lineEnd (size_t): Posición del fin de la línea (sin el salto de línea).
+        - log (LogEntry&): Registro donde se almacenará el resultado.
+    Retorno:
+        - (bool): true si el registro debe agregarse.
+*/
+bool parseLogLine(const LargeString& buffer, size_t lineStart, size_t lineEnd, LogEntry& log) {
+    LineTokens tokens;
+    if (!tokenizeLine(buffer.data() + lineStart, lineEnd - lineStart, tokens)) return false; // Línea vacía o incompleta
+
+    Span fields[4];
+    for (int i = 0; i < 4; ++i) {
+        fields[i] = {lineStart + tokens.start[i], tokens.end[i] - tokens.start[i]};
+    }
+    Span time = fields[2];
+    Span ipPort = fields[3];
+    Span message = {lineStart + tokens.rest, lineEnd - lineStart - tokens.rest};
+
+    int ip1, ip2, ip3, ip4, port;
+    parseIP(buffer.data() + ipPort.offset, buffer.data() + lineEnd, ip1, ip2, ip3, ip4, port);
+    int hour = extractHour(buffer.data() + time.offset, time.length);
+
+    // Si el intento ocurrió en un horario sospechoso (00:00 - 05:00), registrarlo
+    if (hour >= 0 && hour < 5) {
+        unsigned long long ipKey = 0;
+        for (int octet : {ip1, ip2, ip3, ip4}) ipKey = (ipKey << 10) | (octet & 1023);
+        log = {fields[0], fields[1], time, ipPort, port, message, (ipKey << 16) | (port & 0xFFFF)};
+        return true;
+    }
+    return false;
+}
+
 /*
     Función: loadLogFile
-    Descripción: Carga el archivo de bitácora y almacena los intentos en una lista de adyacencia.
+    Descripción: Carga el archivo de bitácora en un búfer y construye el grafo de puertos atacados.
+        La lectura e interpretación se hacen en paralelo con loadParallelAsync (lecturas asíncronas
+        compilado con C++20, loadParallel con C++17); los lotes llegan en el orden del archivo. Al terminar, el grafo se arma en paralelo con búferes de aristas por hilo. Los
+        registros hacen referencia al búfer, por lo que este debe mantenerse vivo mientras se usen.
     Parámetros:
         - filename (string): Nombre del archivo de bitácora.
+        - buffer (LargeString&): Búfer donde se almacenará el contenido del archivo.
         - logs (vector<LogEntry>&): Vector donde se almacenarán los registros.
-        - portAdjacencyList (map<int, set<string>>&): Lista de adyacencia de puertos atacados.
+        - portFanIn (PortFanIn&): Atacantes distintos de cada puerto (exactos o aproximados).
     Retorno:
         - Ninguno.
 */
-void loadLogFile(const string& filename, vector<LogEntry>& logs, map<int, set<string>>& portAdjacencyList) {
-    ifstream file(filename);
-    if (!file) {
+void loadLogFile(const string& filename, LargeString& buffer, vector<LogEntry>& logs, PortFanIn& portFanIn) {
+    bool opened = loadParallelAsync<LogEntry>(filename, buffer, parseLogLine, [&](vector<LogEntry>&& batch) {
+        for (LogEntry& log : batch) {
+            if (portFanIn.precision > 0) portFanIn.add(log.port, view(buffer, log.ip));
+            logs.push_back(move(log));
+        }
+    });
+    if (!opened) {
         cerr << "Error al abrir el archivo " << filename << endl;
         return;
     }
 
-    string line;
-    while (getline(file, line)) {
-        stringstream ss(line);
-        string month, day, time, ipPort, message;
-
-        ss >> month >> day >> time >> ipPort;
-        getline(ss, message);
-
-        int ip1, ip2, ip3, ip4, port;
-        parseIP(ipPort, ip1, ip2, ip3, ip4, port);
-        int hour = extractHour(time);
-        
-        // Si el intento ocurrió en un horario sospechoso (00:00 - 05:00), registrarlo
-        if (hour >= 0 && hour < 5) {
-            portAdjacencyList[port].insert(ipPort);
-            logs.push_back({month + "-" + day, time, ipPort, port, message});
+    if (portFanIn.precision == 0) {
+        // Último intento como admin de cada puerto, el mismo que reporta findMostAttackedPortAndBotMaster
+        map<int, size_t> lastAdmin;
+        for (size_t i = 0; i < logs.size(); ++i) {
+            if (view(buffer, logs[i].message).find("admin") != string_view::npos) lastAdmin[logs[i].port] = i;
         }
+        portFanIn.graph = buildAttackGraph(logs, [&](const LogEntry& log, AttackEdge& edge) {
+            uint8_t flags = 0;
+            auto last = lastAdmin.find(log.port);
+            if (last != lastAdmin.end()) {
+                if (view(buffer, log.message).find("admin") != string_view::npos) flags |= EDGE_ADMIN_ATTEMPT;
+                if (&log == &logs[last->second]) flags |= EDGE_LAST_ADMIN_ATTEMPT;
+            }
+            edge = {log.port, log.ipKey, flags};
+            return true;
+        });
     }
-    file.close();
 }
 
 /*
     Función: findMostAttackedPortAndBotMaster
     Descripción: Encuentra el puerto más atacado y determina un posible bot master.
     Parámetros:
+        - buffer (const LargeString&): Búfer con el contenido del archivo de entrada.
         - logs (const vector<LogEntry>&): Vector con los registros.
-        - portAdjacencyList (const map<int, set<string>>&): Lista de adyacencia con los puertos atacados.
+        - portFanIn (const PortFanIn&): Atacantes distintos de cada puerto (exactos o aproximados).
     Retorno:
         - Ninguno.
 */
-void findMostAttackedPortAndBotMaster(const vector<LogEntry>& logs, const map<int, set<string>>& portAdjacencyList) {
+void findMostAttackedPortAndBotMaster(const LargeString& buffer, const vector<LogEntry>& logs, const PortFanIn& portFanIn) {
     int mostAttackedPort = -1;
-    int maxFanOut = 0;
+    long long maxFanOut = 0;
     
-    for (const auto& entry : portAdjacencyList) {
-        if (entry.second.size() > maxFanOut) {
-            maxFanOut = entry.second.size();
+    for (const auto& entry : portFanIn.counts()) {
+        long long fanOut = llround(entry.second);
+        if (fanOut > maxFanOut) {
+            maxFanOut = fanOut;
             mostAttackedPort = entry.first;
         }
     }
     
-    cout << "\nPuerto más atacado en horas sospechosas: " << mostAttackedPort << " con " << maxFanOut << " IPs atacantes distintas." << endl;
+    if (portFanIn.precision == 0) {
+        cout << "\nPuerto más atacado en horas sospechosas: " << mostAttackedPort << " con " << maxFanOut << " IPs atacantes distintas." << endl;
+    } else {
+        double error = HyperLogLog(portFanIn.precision).standardError();
+        cout << "\nPuerto más atacado en horas sospechosas: " << mostAttackedPort << " con aproximadamente " << maxFanOut
+             << " IPs atacantes distintas (error estándar " << error * 100 << "%)." << endl;
+    }
     cout << "\nRegistros asociados a este puerto:" << endl;
     
-    string possibleBotMaster;
+    string_view possibleBotMaster;
     for (const auto& log : logs) {
         if (log.port == mostAttackedPort) {
-            cout << log.date << " " << log.time << " " << log.ip << " - " << log.message << endl;
-            if (log.message.find("admin") != string::npos) {
-                possibleBotMaster = log.ip;
+            string_view message = view(buffer, log.message);
+            cout << view(buffer, log.month) << "-" << view(buffer, log.day) << " " << view(buffer, log.time) << " "
+                 << view(buffer, log.ip) << " - " << message << '\n';
+            if (message.find("admin") != string_view::npos) {
+                possibleBotMaster = view(buffer, log.ip);
             }
         }
     }
@@ -137,24 +258,132 @@ void findMostAttackedPortAndBotMaster(const vector<LogEntry>& logs, const map<in
     }
 }
 
+/*
+    Función: formatAttacker
+    Descripción: Convierte la clave numérica de un atacante a su texto "IP:puerto".
+    Parámetros:
+        - key (unsigned long long): Octetos de 10 bits y puerto de 16 bits.
+    Retorno:
+        - (string): Texto del atacante.
+*/
+string formatAttacker(unsigned long long key) {
+    string text;
+    for (int octet = 0; octet < 4; ++octet) {
+        if (octet > 0) text += '.';
+        text += to_string((key >> (16 + 10 * (3 - octet))) & 1023);
+    }
+    return text + ":" + to_string(key & 0xFFFF);
+}
+
+/*
+    Función: reportFromGraph
+    Descripción: Encuentra el puerto más atacado y el posible bot master usando solo el grafo
+        (por ejemplo, uno guardado en disco), sin los registros de texto. Igual que
+        findMostAttackedPortAndBotMaster, el bot master es el del último intento como admin.
+    Parámetros:
+        - graph (const AttackGraphView&): Grafo puerto -> atacantes.
+    Retorno:
+        - Ninguno.
+*/
+void reportFromGraph(const AttackGraphView& graph) {
+    long mostAttacked = -1;
+    size_t maxFanOut = 0;
+    for (size_t i = 0; i < graph.portCount; ++i) {
+        if (graph.fanOut(i) > maxFanOut) {
+            maxFanOut = graph.fanOut(i);
+            mostAttacked = i;
+        }
+    }
+    if (mostAttacked < 0) {
+        cout << "\nEl grafo no tiene puertos atacados." << endl;
+        return;
+    }
+
+    cout << "\nPuerto más atacado en horas sospechosas: " << graph.ports[mostAttacked] << " con " << maxFanOut
+         << " IPs atacantes distintas." << endl;
+    bool found = false;
+    for (uint32_t i = graph.offsets[mostAttacked]; i < graph.offsets[mostAttacked + 1] && !found; ++i) {
+        if (graph.edgeFlags[i] & EDGE_LAST_ADMIN_ATTEMPT) {
+            cout << "\nPosible Bot Master: " << formatAttacker(graph.attackers[graph.neighbours[i]])
+                 << " intentó acceder como admin." << endl;
+            found = true;
+        }
+    }
+    if (!found) {
+        cout << "\nNo se encontró un intento de acceso a 'admin'." << endl;
+    }
+}
+
 /*
     Función: main
     Descripción: Función principal que ejecuta el programa.
+        Opciones:
+        - "--aproximado [precisión]": estima los atacantes distintos por puerto con HyperLogLog.
+        - "--guardar archivo": guarda el grafo construido en formato binario.
+        - "--grafo archivo...": usa grafos guardados (proyectados con mmap y unidos si son varios)
+          en lugar de leer la bitácora.
     Parámetros:
-        - Ninguno.
+        - argc (int), argv (char*[]): Argumentos de la línea de comandos.
     Retorno:
         - (int): Código de salida del programa (0 si ejecuta correctamente).
 */
-int main() {
+int main(int argc, char* argv[]) {
     string filename = "bitacora.txt";
+    LargeString buffer; // Contenido del archivo (referenciado por los registros)
     vector<LogEntry> logs;
-    map<int, set<string>> portAdjacencyList;
+    PortFanIn portFanIn = {0, {}, {}};
+    string graphOutput;
+    vector<string> graphInputs;
+    for (int i = 1; i < argc; ++i) {
+        string argument = argv[i];
+        if (argument == "--aproximado") {
+            portFanIn.precision = i + 1 < argc && isdigit(argv[i + 1][0]) ? atoi(argv[++i]) : HLL_DEFAULT_PRECISION;
+            portFanIn.precision = max(HLL_MIN_PRECISION, min(HLL_MAX_PRECISION, portFanIn.precision));
+        } else if (argument == "--guardar" && i + 1 < argc) {
+            graphOutput = argv[++i];
+        } else if (argument == "--grafo") {
+            while (i + 1 < argc && argv[i + 1][0] != '-') graphInputs.push_back(argv[++i]);
+        }
+    }
+
+    if (!graphInputs.empty()) {
+        // Consultas directamente sobre los grafos guardados
+        vector<MappedAttackGraph> mapped(graphInputs.size());
+        vector<AttackGraphView> views;
+        for (size_t i = 0; i < graphInputs.size(); ++i) {
+            if (!mapped[i].open(graphInputs[i])) {
+                cerr << "Error al abrir el grafo " << graphInputs[i] << endl;
+                return 1;
+            }
+            views.push_back(mapped[i].view());
+        }
+        AttackGraph merged;
+        if (views.size() > 1) merged = unionAttackGraphs(views);
+        AttackGraphView graph = views.size() > 1 ? merged.view() : views[0];
+        reportFromGraph(graph);
+        if (!graphOutput.empty() && !saveAttackGraph(graph, graphOutput)) {
+            cerr << "Error al guardar el grafo " << graphOutput << endl;
+            return 1;
+        }
+        return 0;
+    }
 
     // Cargar datos del archivo y analizar intentos sospechosos
-    loadLogFile(filename, logs, portAdjacencyList);
+    loadLogFile(filename, buffer, logs, portFanIn);
 
     // Encontrar el puerto más atacado y un posible bot master
-    findMostAttackedPortAndBotMaster(logs, portAdjacencyList);
-    
+    findMostAttackedPortAndBotMaster(buffer, logs, portFanIn);
+
+    if (!graphOutput.empty()) {
+        if (portFanIn.precision > 0) {
+            cerr << "El grafo solo se puede guardar en el modo exacto." << endl;
+            return 1;
+        }
+        if (!saveAttackGraph(portFanIn.graph.view(), graphOutput)) {
+            cerr << "Error al guardar el grafo " << graphOutput << endl;
+            return 1;
+        }
+        cout << "\nGrafo guardado en: " << graphOutput << endl;
+    }
     return 0;
 }
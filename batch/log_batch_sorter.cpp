@@ -0,0 +1,231 @@
+/*
+ * Programa que ordena por fecha muchas bitácoras a la vez (por ejemplo, las de varios
+ * días o varios servidores), con E/S asíncrona de common/async_io.h. Cada archivo lo
+ * atiende una corrutina que lee por bloques con varias lecturas en curso, interpreta cada
+ * tramo de líneas completas en cuanto llega, ordena y escribe con doble búfer. Mientras
+ * una corrutina espera al disco, las demás interpretan, ordenan o dan formato a sus
+ * archivos en el grupo de hilos, así que la lectura, el ordenamiento y la escritura de
+ * archivos distintos se traslapan.
+ *
+ * Cada entrada produce <salida>/sorted_<nombre> con el formato de act1.3 (el mismo de
+ * sorted_logs.txt del programa de análisis). Los archivos comprimidos se cargan con
+ * common/parallel_loader.h dentro del grupo de hilos.
+ *
+ * Compilación (desde la raíz del repositorio; requiere C++20 por las corrutinas):
+ *   g++ -std=c++20 -O2 -pthread batch/log_batch_sorter.cpp -o log_batch_sorter
+ * Uso:
+ *   ./log_batch_sorter [--salida dir] [--concurrentes n] [--hilos n] [--io uring|hilos] archivos...
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "../common/async_io.h"
+#include "../common/log_record.h"
+#include "../common/sort_kernels.h"
+
+using namespace std;
+
+// Parámetros del procesamiento por lotes
+struct BatchOptions {
+    string outputDir = ".";
+    unsigned concurrent = 8;         // Archivos atendidos a la vez
+    size_t readSize = 4 << 20;       // Bytes por lectura
+    unsigned readsInFlight = 4;      // Lecturas en curso por archivo
+    size_t writeBlock = 1 << 20;     // Bytes por escritura
+};
+
+// Resultado de un archivo
+struct FileResult {
+    string input;
+    string output;
+    bool ok = false;
+    size_t records = 0;
+    double milliseconds = 0;
+};
+
+/*
+ * Interpreta las líneas completas de [begin, end) del búfer.
+ * Complejidad: O(k), donde k es la cantidad de bytes.
+ */
+void parseLines(const LargeString& buffer, size_t begin, size_t end, vector<Record>& records) {
+    size_t lineStart = begin;
+    while (lineStart < end) {
+        const char* newline = static_cast<const char*>(memchr(buffer.data() + lineStart, '\n', end - lineStart));
+        size_t lineEnd = newline ? newline - buffer.data() : end;
+        Record record;
+        if (lineEnd > lineStart && parseRecord(buffer, lineStart, lineEnd, record)) records.push_back(record);
+        lineStart = lineEnd + 1;
+    }
+}
+
+/*
+ * Lee e interpreta una bitácora con varias lecturas asíncronas en curso. Cada tramo de
+ * líneas completas se interpreta en el grupo de hilos en cuanto llegan sus bytes, mientras
+ * siguen las lecturas del resto del archivo.
+ * Complejidad: O(n), donde n es el tamaño del archivo.
+ * @return false si el archivo no se pudo abrir o leer.
+ */
+Task<bool> loadLogStoreAsync(IoLoop& loop, const string& filename, LogStore& store, const BatchOptions& options) {
+    AsyncReader reader(loop, options.readSize, options.readsInFlight);
+    if (!reader.open(filename)) co_return false;
+    size_t size = reader.fileSize();
+
+    // Detectar si el archivo está comprimido
+    string header(min<size_t>(size, 18), '\0');
+    ssize_t headerBytes = header.empty() ? 0 : co_await reader.read(&header[0], header.size(), 0);
+    if (headerBytes < 0) co_return false;
+    header.resize(headerBytes);
+    if (detectFormat(header) != InputFormat::Plain) {
+        reader.close();
+        bool ok = false;
+        co_await loop.offload([&]() { ok = loadLogStore(filename, store); });
+        co_return ok;
+    }
+
+    LargeString& buffer = store.buffer;
+    buffer.resize(size);
+    reader.start(&buffer[0]);
+    size_t parsed = 0;
+    bool ok = true;
+    while (!reader.done()) {
+        if (!(co_await reader.next())) {
+            ok = false;
+            break;
+        }
+
+        // Interpretar hasta el último salto de línea disponible
+        size_t readyEnd = reader.ready();
+        size_t end = readyEnd;
+        if (readyEnd < size) {
+            size_t newline = buffer.rfind('\n', readyEnd - 1);
+            end = newline == string::npos || newline < parsed ? parsed : newline + 1;
+        }
+        if (end > parsed) {
+            vector<Record> part;
+            co_await loop.offload([&]() { parseLines(buffer, parsed, end, part); });
+            store.records.insert(store.records.end(), part.begin(), part.end());
+            parsed = end;
+        }
+    }
+    // Las lecturas que queden en curso escriben en el búfer: esperarlas antes de salir
+    co_await reader.finish();
+    co_return ok;
+}
+
+/*
+ * Escribe los registros en orden con doble búfer: el grupo de hilos da formato a un
+ * bloque mientras se escribe el anterior.
+ * Complejidad: O(n), donde n es el tamaño de la salida.
+ * @return false si el archivo no se pudo abrir o escribir.
+ */
+Task<bool> writeSortedAsync(IoLoop& loop, const LogStore& store, const string& filename,
+                            const BatchOptions& options) {
+    AsyncWriter writer(loop);
+    if (!writer.open(filename)) co_return false;
+    const LargeVector<Record>& records = store.records;
+    bool ok = true;
+    size_t next = 0;
+    while (next < records.size() && ok) {
+        string& block = writer.buffer();
+        co_await loop.offload([&]() {
+            while (next < records.size() && block.size() < options.writeBlock) {
+                appendSortedEntry(block, store, records[next++]);
+            }
+        });
+        ok = co_await writer.flush();
+    }
+    bool closed = co_await writer.close();
+    co_return ok && closed;
+}
+
+/*
+ * Corrutina de trabajo: toma archivos pendientes de la lista compartida hasta agotarla.
+ * Todas las corrutinas corren en el hilo del IoLoop, así que `next` no necesita candado.
+ */
+Task<void> sortFiles(IoLoop& loop, vector<FileResult>& results, size_t& next, const BatchOptions& options) {
+    while (next < results.size()) {
+        FileResult& result = results[next++];
+        auto start = chrono::steady_clock::now();
+        LogStore store;
+        result.ok = co_await loadLogStoreAsync(loop, result.input, store, options);
+        if (result.ok) {
+            co_await loop.offload([&]() { stableSortBy<TimestampKey>(store.records.begin(), store.records.end()); });
+            result.ok = co_await writeSortedAsync(loop, store, result.output, options);
+        }
+        result.records = store.records.size();
+        result.milliseconds = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    }
+}
+
+// Nombre del archivo sin directorios
+string baseName(const string& path) {
+    size_t slash = path.rfind('/');
+    return slash == string::npos ? path : path.substr(slash + 1);
+}
+
+int main(int argc, char* argv[]) {
+    BatchOptions options;
+    unsigned threads = 0;
+    bool useUring = true;
+    vector<string> inputs;
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "--salida" && i + 1 < argc) {
+            options.outputDir = argv[++i];
+        } else if (arg == "--concurrentes" && i + 1 < argc) {
+            options.concurrent = max(1, atoi(argv[++i]));
+        } else if (arg == "--hilos" && i + 1 < argc) {
+            threads = max(0, atoi(argv[++i]));
+        } else if (arg == "--io" && i + 1 < argc) {
+            useUring = string(argv[++i]) != "hilos";
+        } else {
+            inputs.push_back(arg);
+        }
+    }
+    if (inputs.empty()) {
+        cerr << "Uso: " << argv[0]
+             << " [--salida dir] [--concurrentes n] [--hilos n] [--io uring|hilos] archivos..." << endl;
+        return 1;
+    }
+
+    // Entradas con el mismo nombre (de directorios distintos) se distinguen con su posición
+    vector<FileResult> results(inputs.size());
+    set<string> usedNames;
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        string name = "sorted_" + baseName(inputs[i]);
+        if (!usedNames.insert(name).second) name = "sorted_" + to_string(i) + "_" + baseName(inputs[i]);
+        results[i].input = inputs[i];
+        results[i].output = options.outputDir + "/" + name;
+    }
+
+    auto start = chrono::steady_clock::now();
+    IoLoop loop(useUring, threads);
+    size_t next = 0;
+    for (unsigned i = 0; i < min<size_t>(options.concurrent, inputs.size()); ++i) {
+        loop.spawn(sortFiles(loop, results, next, options));
+    }
+    loop.run();
+    double milliseconds = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+
+    size_t totalRecords = 0, failed = 0;
+    for (const FileResult& result : results) {
+        if (!result.ok) {
+            cerr << "Error al procesar el archivo: " << result.input << endl;
+            ++failed;
+            continue;
+        }
+        totalRecords += result.records;
+        printf("%s -> %s (%zu registros, %.1f ms)\n", result.input.c_str(), result.output.c_str(), result.records,
+               result.milliseconds);
+    }
+    printf("Archivos: %zu, registros: %zu, tiempo: %.1f ms, E/S: %s, concurrentes: %u\n",
+           inputs.size() - failed, totalRecords, milliseconds, loop.backendName(), options.concurrent);
+    return failed == 0 ? 0 : 1;
+}
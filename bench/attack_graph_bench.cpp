@@ -0,0 +1,105 @@
+/*
+ * Benchmark de construcción del grafo puerto -> atacantes de act4.3.
+ * Compara la construcción original (map<int, set<string>>, una arista a la vez en un
+ * solo hilo) contra la construcción en paralelo en formato CSR de common/attack_graph.h
+ * con distintas cantidades de hilos, y verifica que ambos grafos coincidan.
+ *
+ * Compilación (desde la raíz del repositorio):
+ *   g++ -std=c++17 -O2 -pthread bench/attack_graph_bench.cpp -o attack_graph_bench
+ * Uso:
+ *   ./attack_graph_bench bitacora.txt [hilos máximos]
+ */
+
+#include "../common/attack_graph.h"
+#include "../common/log_tokenizer.h"
+#include "../common/parallel_loader.h"
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <set>
+#include <string>
+
+using namespace std;
+
+// Intento de acceso con los campos que usa el grafo de act4.3
+struct BenchRecord {
+    size_t ipOffset; // Texto "IP:puerto" dentro del búfer
+    size_t ipLength;
+    int hour;
+    int port;
+    unsigned long long ipKey;
+};
+
+/*
+ * Interpreta una línea "Mes día hh:mm:ss IP:puerto mensaje" con common/log_tokenizer.h.
+ * Complejidad: O(k), donde k es la longitud de la línea.
+ */
+bool parseBenchLine(const LargeString& buffer, size_t lineStart, size_t lineEnd, BenchRecord& record) {
+    LineTokens tokens;
+    const char* line = buffer.data() + lineStart;
+    if (!tokenizeLine(line, lineEnd - lineStart, tokens)) return false;
+
+    int minute, second, octets[4];
+    parseClock(line + tokens.start[2], tokens.end[2] - tokens.start[2], record.hour, minute, second);
+    parseIPPort(line + tokens.start[3], buffer.data() + lineEnd, octets, record.port);
+    record.ipOffset = lineStart + tokens.start[3];
+    record.ipLength = tokens.end[3] - tokens.start[3];
+    record.ipKey = 0;
+    for (int octet : octets) record.ipKey = (record.ipKey << 10) | (octet & 1023);
+    record.ipKey = (record.ipKey << 16) | (record.port & 0xFFFF);
+    return true;
+}
+
+// Milisegundos transcurridos desde `start`
+double millisecondsSince(chrono::steady_clock::time_point start) {
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        cerr << "Uso: " << argv[0] << " archivo [hilos máximos]" << endl;
+        return 1;
+    }
+    unsigned maxThreads = argc > 2 ? stoi(argv[2]) : max(8u, thread::hardware_concurrency());
+
+    LargeString buffer;
+    vector<BenchRecord> records;
+    bool opened = loadParallel<BenchRecord>(argv[1], buffer, parseBenchLine, [&records](vector<BenchRecord>&& batch) {
+        records.insert(records.end(), batch.begin(), batch.end());
+    });
+    if (!opened) {
+        cerr << "Error al abrir el archivo: " << argv[1] << endl;
+        return 1;
+    }
+
+    // Horario sospechoso (00:00 - 05:00), igual que act4.3
+    auto edgeOf = [](const BenchRecord& record, AttackEdge& edge) {
+        edge = {record.port, record.ipKey, uint8_t(0)};
+        return record.hour < 5;
+    };
+
+    // Construcción original: un árbol por puerto con una cadena por atacante
+    auto start = chrono::steady_clock::now();
+    map<int, set<string>> adjacency;
+    for (const BenchRecord& record : records) {
+        if (record.hour < 5) adjacency[record.port].insert(string(buffer, record.ipOffset, record.ipLength));
+    }
+    double baseline = millisecondsSince(start);
+    cout << "Registros: " << records.size() << ", puertos atacados: " << adjacency.size() << endl;
+    cout << "map<int, set<string>>: " << baseline << " ms" << endl;
+
+    for (unsigned threads = 1; threads <= maxThreads; threads *= 2) {
+        start = chrono::steady_clock::now();
+        AttackGraph graph = buildAttackGraph(records, edgeOf, threads);
+        double elapsed = millisecondsSince(start);
+
+        bool same = graph.ports.size() == adjacency.size();
+        size_t index = 0;
+        for (auto it = adjacency.begin(); same && it != adjacency.end(); ++it, ++index) {
+            same = graph.ports[index] == it->first && graph.fanOut(index) == it->second.size();
+        }
+        cout << "CSR con " << threads << " hilo(s): " << elapsed << " ms (" << baseline / elapsed << "x)"
+             << (same ? "" : " [no coincide con el grafo original]") << endl;
+    }
+    return 0;
+}
@@ -0,0 +1,115 @@
+/*
+ * Benchmark de memoria y precisión del conteo de atacantes distintos por puerto.
+ * Compara los conjuntos exactos de act4.3 (set<string>) contra un HyperLogLog
+ * (common/hyperloglog.h) con varias precisiones y cardinalidades. Los atacantes son
+ * cadenas "a.b.c.d:puerto" generadas al azar con el mismo formato de la bitácora.
+ * La memoria del conjunto se mide con un asignador que cuenta nodos y cadenas.
+ *
+ * Compilación (desde la raíz del repositorio):
+ *   g++ -std=c++17 -O2 bench/hyperloglog_bench.cpp -o hyperloglog_bench
+ * Uso:
+ *   ./hyperloglog_bench [cardinalidad máxima]
+ */
+
+#include "../common/hyperloglog.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Bytes reservados en este momento por los conjuntos exactos
+static size_t allocatedBytes = 0;
+
+// Asignador que lleva la cuenta de los bytes reservados (nodos del conjunto y cadenas)
+template <typename T>
+struct CountingAllocator {
+    using value_type = T;
+
+    CountingAllocator() {}
+    template <typename U>
+    CountingAllocator(const CountingAllocator<U>&) {}
+
+    T* allocate(size_t count) {
+        allocatedBytes += count * sizeof(T);
+        return allocator<T>().allocate(count);
+    }
+    void deallocate(T* pointer, size_t count) {
+        allocatedBytes -= count * sizeof(T);
+        allocator<T>().deallocate(pointer, count);
+    }
+};
+
+template <typename T, typename U>
+bool operator==(const CountingAllocator<T>&, const CountingAllocator<U>&) { return true; }
+template <typename T, typename U>
+bool operator!=(const CountingAllocator<T>&, const CountingAllocator<U>&) { return false; }
+
+// Conjunto exacto de atacantes como el de act4.3, con la memoria contada
+typedef basic_string<char, char_traits<char>, CountingAllocator<char>> CountedString;
+typedef set<CountedString, less<CountedString>, CountingAllocator<CountedString>> ExactSet;
+
+// Segundos transcurridos desde `start`
+double secondsSince(chrono::steady_clock::time_point start) {
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+/*
+ * Genera un atacante "a.b.c.d:puerto" con octetos de hasta tres dígitos (como la bitácora).
+ * Complejidad: O(1).
+ */
+string randomAttacker(mt19937_64& generator) {
+    char text[32];
+    snprintf(text, sizeof(text), "%d.%d.%d.%d:%d", int(generator() % 1000), int(generator() % 1000),
+             int(generator() % 1000), int(generator() % 1000), int(1000 + generator() % 9000));
+    return text;
+}
+
+int main(int argc, char* argv[]) {
+    size_t maxCardinality = argc > 1 ? strtoull(argv[1], nullptr, 10) : 1000000;
+    const int precisions[] = {8, 10, 12, 14, 16};
+    mt19937_64 generator(2025);
+
+    printf("%10s %12s %10s | %4s %10s %12s %9s %9s %10s\n", "distintos", "set bytes", "set ms", "p", "HLL bytes",
+           "estimación", "error", "esperado", "HLL ms");
+    for (size_t cardinality = 10; cardinality <= maxCardinality; cardinality *= 10) {
+        // Cada atacante aparece dos veces, como un atacante que repite intentos
+        vector<string> attackers;
+        attackers.reserve(cardinality * 2);
+        for (size_t i = 0; i < cardinality; ++i) attackers.push_back(randomAttacker(generator));
+        for (size_t i = 0; i < cardinality; ++i) attackers.push_back(attackers[i]);
+
+        // Modo exacto de act4.3
+        size_t before = allocatedBytes;
+        auto start = chrono::steady_clock::now();
+        size_t exactBytes, distinct;
+        double exactSeconds;
+        {
+            ExactSet exact;
+            for (const string& attacker : attackers) exact.insert(CountedString(attacker.data(), attacker.size()));
+            exactSeconds = secondsSince(start);
+            exactBytes = allocatedBytes - before;
+            distinct = exact.size();
+        }
+
+        for (int precision : precisions) {
+            HyperLogLog sketch(precision);
+            start = chrono::steady_clock::now();
+            for (const string& attacker : attackers) sketch.add(attacker.data(), attacker.size());
+            double estimate = sketch.estimate();
+            double sketchSeconds = secondsSince(start);
+
+            double error = (estimate - distinct) / distinct;
+            printf("%10zu %12zu %10.2f | %4d %10zu %12.0f %8.2f%% %8.2f%% %10.2f\n", distinct, exactBytes,
+                   exactSeconds * 1000, precision, sketch.memoryBytes(), estimate, error * 100,
+                   sketch.standardError() * 100, sketchSeconds * 1000);
+        }
+    }
+    return 0;
+}
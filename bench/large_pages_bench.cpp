@@ -0,0 +1,120 @@
+/*
+ * Benchmark de latencia de accesos aleatorios sobre arreglos grandes con cada tipo de
+ * página de common/large_pages.h (normales, transparentes y explícitas).
+ * Mide dos patrones típicos de los análisis sobre la bitácora en memoria:
+ *  - búsqueda binaria (lower_bound) sobre claves ordenadas, como las consultas por rango;
+ *  - sondeos de una tabla hash abierta, como el conteo de accesos por IP.
+ * Para cada política informa qué páginas se obtuvieron en realidad (si el sistema no tiene
+ * páginas explícitas reservadas o no soporta THP, se usa el respaldo siguiente).
+ *
+ * Compilación (desde la raíz del repositorio):
+ *   g++ -std=c++17 -O2 -pthread bench/large_pages_bench.cpp -o large_pages_bench
+ * Uso:
+ *   ./large_pages_bench [MB por arreglo] [sondeos]
+ */
+
+#include "../common/hyperloglog.h"
+#include "../common/large_pages.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <random>
+#include <string>
+
+using namespace std;
+
+// Nanosegundos transcurridos desde `start`
+double nanosecondsSince(chrono::steady_clock::time_point start) {
+    return chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+}
+
+/*
+ * KB de memoria anónima del proceso respaldada por páginas grandes transparentes.
+ * Complejidad: O(1).
+ * @return -1 si el sistema no expone la información.
+ */
+long anonHugePagesKB() {
+    ifstream file("/proc/self/smaps_rollup");
+    string field;
+    long value;
+    while (file >> field) {
+        if (field == "AnonHugePages:" && file >> value) return value;
+    }
+    return -1;
+}
+
+/*
+ * Tabla hash abierta de claves de 64 bits con sondeo lineal (0 marca una celda vacía).
+ * Complejidad: O(1) promedio por operación.
+ */
+struct ProbeTable {
+    LargeVector<unsigned long long> slots;
+    size_t mask;
+
+    explicit ProbeTable(size_t capacity) : slots(capacity, 0), mask(capacity - 1) {}
+
+    void insert(unsigned long long key) {
+        size_t slot = mixHash(key) & mask;
+        while (slots[slot] != 0 && slots[slot] != key) slot = (slot + 1) & mask;
+        slots[slot] = key;
+    }
+
+    bool contains(unsigned long long key) const {
+        for (size_t slot = mixHash(key) & mask;; slot = (slot + 1) & mask) {
+            if (slots[slot] == key) return true;
+            if (slots[slot] == 0) return false;
+        }
+    }
+};
+
+int main(int argc, char* argv[]) {
+    size_t megabytes = argc > 1 ? strtoull(argv[1], nullptr, 10) : 512;
+    size_t probes = argc > 2 ? strtoull(argv[2], nullptr, 10) : 4000000;
+    size_t count = megabytes * (1 << 20) / sizeof(unsigned long long);
+    size_t capacity = 1;
+    while (capacity < count) capacity <<= 1;
+
+    const PagePolicy policies[] = {PagePolicy::Normal, PagePolicy::Transparent, PagePolicy::Explicit};
+    const char* names[] = {"normales", "transparentes", "explícitas"};
+    printf("Arreglos de %zu MB, %zu sondeos, nodos NUMA: %d\n", megabytes, probes, numaNodeCount());
+    printf("%-14s %-26s %12s %14s %14s\n", "política", "páginas obtenidas (MB)", "THP (MB)", "lower_bound ns",
+           "tabla hash ns");
+
+    for (int p = 0; p < 3; ++p) {
+        setPagePolicy(policies[p]);
+        LargePageStats& stats = largePageStats();
+        size_t explicitBefore = stats.explicitBytes, transparentBefore = stats.transparentBytes,
+               normalBefore = stats.normalBytes;
+
+        // Claves ordenadas (impares, para que la mitad de las búsquedas no las encuentre)
+        LargeVector<unsigned long long> keys(count);
+        for (size_t i = 0; i < count; ++i) keys[i] = 2 * i + 1;
+        ProbeTable table(capacity);
+        for (size_t i = 0; i < count / 2; ++i) table.insert(keys[2 * i]);
+
+        char obtained[64];
+        snprintf(obtained, sizeof(obtained), "E %zu / T %zu / N %zu", (stats.explicitBytes - explicitBefore) >> 20,
+                 (stats.transparentBytes - transparentBefore) >> 20, (stats.normalBytes - normalBefore) >> 20);
+        long hugeKB = anonHugePagesKB();
+
+        mt19937_64 generator(2025);
+        size_t found = 0;
+        auto start = chrono::steady_clock::now();
+        for (size_t i = 0; i < probes; ++i) {
+            unsigned long long target = generator() % (2 * count);
+            found += *lower_bound(keys.begin(), keys.end(), target) == target;
+        }
+        double searchNs = nanosecondsSince(start) / probes;
+
+        start = chrono::steady_clock::now();
+        for (size_t i = 0; i < probes; ++i) found += table.contains(generator() % (2 * count) | 1);
+        double tableNs = nanosecondsSince(start) / probes;
+
+        printf("%-14s %-26s %12s %14.1f %14.1f\n", names[p], obtained,
+               hugeKB < 0 ? "?" : to_string(hugeKB >> 10).c_str(), searchNs, tableNs);
+        if (found == 0) printf("(sin coincidencias)\n");
+    }
+    return 0;
+}
@@ -0,0 +1,301 @@
+/*
+ * Benchmark de reservas de memoria del recorrido completo carga -> orden -> escritura.
+ * Cuenta las llamadas a operator new con registros de campos fijos (common/log_record.h,
+ * sin cadenas por registro), con los recorridos de act1.3 (loadLogFile, quickSort,
+ * writeLogsToFile) y act2.3 (loadLogFile, sortByIP, printToFile), y con registros de
+ * cadenas como los que se usaban antes (una cadena por campo, copiados a la lista de
+ * registros). La bitácora se repite 1, 4, 16 y 64 veces: con registros fijos y en las
+ * actividades la cantidad de reservas no depende de la cantidad de líneas (los registros
+ * o los nodos se reservan de una vez con la estimación del primer lote y el pipeline
+ * recicla un grupo fijo de vectores), mientras que con cadenas crece con cada línea. Si
+ * en alguno de los casos sin cadenas la cantidad cambia entre la primera y la última
+ * repetición, el programa termina con código 1.
+ * act1.3 y act2.3 se compilan dentro del benchmark, cada una en su espacio de nombres
+ * (sus tipos Span y LogEntry son distintos), con la E/S bloqueante de common/async_files.h
+ * (la asíncrona reserva memoria por cada bloque leído o escrito).
+ * Se usan segmentos pequeños (BENCH_CHUNK_SIZE) para que desde la primera repetición la
+ * bitácora ocupe más segmentos que los vectores del grupo del pipeline, y antes de medir
+ * se hace una carga sin contar para que las reservas que se hacen una sola vez por
+ * programa (como la lectura de los nodos NUMA en common/large_pages.h) no caigan en x1.
+ *
+ * Compilación (desde la raíz del repositorio; también con -std=c++20):
+ *   g++ -std=c++17 -O2 -pthread bench/record_allocations_bench.cpp -o record_allocations_bench
+ * Uso:
+ *   ./record_allocations_bench bitacora.txt [repeticiones máximas]
+ */
+
+#define BITACORA_IO_BLOQUEANTE
+
+#include "../common/async_files.h"
+#include "../common/log_record.h"
+#include "../common/sort_kernels.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cctype>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iosfwd>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <sstream>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+#include <sys/stat.h>
+
+using namespace std;
+
+// Los headers que usan las actividades ya están incluidos arriba, así que dentro de los
+// espacios de nombres solo queda el código de cada actividad
+namespace act13 {
+#define main act13Main
+#include "../act1.3.cpp"
+#undef main
+}
+
+namespace act23 {
+#include "../act2.3/doubly_linked_list.cpp"
+}
+
+// Reservas hechas con operator new desde que empezó el programa
+static atomic<size_t> allocationCount(0);
+
+void* operator new(size_t size) {
+    allocationCount.fetch_add(1, memory_order_relaxed);
+    if (void* pointer = malloc(size ? size : 1)) return pointer;
+    throw bad_alloc();
+}
+// Sin inline: si g++ ve free() junto a una reserva con new avisa -Wmismatched-new-delete
+__attribute__((noinline)) void operator delete(void* pointer) noexcept { free(pointer); }
+void operator delete(void* pointer, size_t) noexcept { operator delete(pointer); }
+
+// Flujo que descarta lo que se escribe (los mensajes de las actividades)
+struct NullBuffer : streambuf {
+    int overflow(int c) override { return c; }
+};
+
+// Hilos intérpretes y tamaño de segmento de las cargas del benchmark
+const unsigned BENCH_THREADS = 2;
+const size_t BENCH_CHUNK_SIZE = 16 << 10;
+
+// Registro con una cadena por campo (la forma en que se guardaban antes los registros)
+struct StringRecord {
+    string date;
+    string time;
+    string ip;
+    string message;
+    int timestamp;
+};
+
+/*
+ * Interpreta una línea en un registro de cadenas.
+ * Complejidad: O(k), donde k es la longitud de la línea.
+ */
+bool parseStringRecord(const LargeString& buffer, size_t lineStart, size_t lineEnd, StringRecord& record) {
+    Record fixed;
+    if (!parseRecord(buffer, lineStart, lineEnd, fixed)) return false;
+    char date[8];
+    snprintf(date, sizeof(date), "%02d-%02d", fixed.monthNumber, fixed.dayNumber);
+    record.date = date;
+    record.time.assign(buffer, fixed.time.offset, fixed.time.length);
+    record.ip.assign(buffer, fixed.ip.offset, fixed.ip.length);
+    record.message.assign(buffer, fixed.message.offset, fixed.message.length);
+    record.timestamp = fixed.timestamp;
+    return true;
+}
+
+// Reservas de cada etapa de un recorrido
+struct StageCounts {
+    size_t records;
+    size_t load;
+    size_t sort;
+    size_t write;
+};
+
+/*
+ * Carga, ordena por fecha y escribe una bitácora con registros de campos fijos.
+ * Los registros se guardan en un vector normal (no LargeVector) para que todas las
+ * reservas pasen por operator new y se cuenten.
+ */
+StageCounts runFixedRecords(const string& filename, const string& outputFile) {
+    StageCounts counts;
+    size_t start = allocationCount;
+    LogStore store;
+    vector<Record> records;
+    loadParallel<Record>(filename, store.buffer, parseRecord, [&](vector<Record>&& batch) {
+        reserveFromFirstBatch(records, batch, store.buffer.size());
+        records.insert(records.end(), make_move_iterator(batch.begin()), make_move_iterator(batch.end()));
+    }, BENCH_THREADS, BENCH_CHUNK_SIZE);
+    counts.records = records.size();
+    counts.load = allocationCount - start;
+
+    start = allocationCount;
+    quickSortBy<TimestampKey>(records.begin(), records.end());
+    counts.sort = allocationCount - start;
+
+    start = allocationCount;
+    {
+        ofstream file(outputFile);
+        for (const Record& record : records) writeSortedEntry(file, store, record);
+    }
+    counts.write = allocationCount - start;
+    return counts;
+}
+
+/*
+ * Recorrido de act1.3: carga en el vector de registros, Quick Sort por fecha y escritura.
+ */
+StageCounts runAct13(const string& filename, const string& outputFile) {
+    StageCounts counts;
+    size_t start = allocationCount;
+    LargeString buffer;
+    vector<act13::LogEntry> logs;
+    act13::loadLogFile(filename, buffer, logs, false, BENCH_THREADS, BENCH_CHUNK_SIZE);
+    counts.records = logs.size();
+    counts.load = allocationCount - start;
+
+    start = allocationCount;
+    act13::quickSort(logs, 0, logs.size() - 1);
+    counts.sort = allocationCount - start;
+
+    start = allocationCount;
+    act13::writeLogsToFile(outputFile, buffer, logs);
+    counts.write = allocationCount - start;
+    return counts;
+}
+
+/*
+ * Recorrido de act2.3: carga en la lista doblemente enlazada, orden por IP y escritura.
+ */
+StageCounts runAct23(const string& filename, const string& outputFile) {
+    StageCounts counts;
+    size_t start = allocationCount;
+    act23::DoublyLinkedList list;
+    act23::loadLogFile(filename, list, BENCH_THREADS, BENCH_CHUNK_SIZE);
+    counts.records = 0;
+    for (act23::Node* node = list.getHead(); node; node = node->next) ++counts.records;
+    counts.load = allocationCount - start;
+
+    start = allocationCount;
+    list.sortByIP();
+    counts.sort = allocationCount - start;
+
+    start = allocationCount;
+    list.printToFile(outputFile);
+    counts.write = allocationCount - start;
+    return counts;
+}
+
+/*
+ * El mismo recorrido con registros de cadenas copiados a la lista.
+ */
+StageCounts runStringRecords(const string& filename, const string& outputFile) {
+    StageCounts counts;
+    size_t start = allocationCount;
+    LargeString buffer;
+    vector<StringRecord> records;
+    loadParallel<StringRecord>(filename, buffer, parseStringRecord, [&records](vector<StringRecord>&& batch) {
+        for (const StringRecord& record : batch) records.push_back(record);
+    }, BENCH_THREADS, BENCH_CHUNK_SIZE);
+    counts.records = records.size();
+    counts.load = allocationCount - start;
+
+    start = allocationCount;
+    quickSortBy<TimestampKey>(records.begin(), records.end());
+    counts.sort = allocationCount - start;
+
+    start = allocationCount;
+    {
+        ofstream file(outputFile);
+        for (const StringRecord& record : records) {
+            file << record.date << ' ' << record.time << ' ' << record.ip << " - " << record.message << '\n';
+        }
+    }
+    counts.write = allocationCount - start;
+    return counts;
+}
+
+// Imprime una fila de resultados y regresa el total de reservas
+size_t printCounts(const char* name, const StageCounts& counts) {
+    size_t total = counts.load + counts.sort + counts.write;
+    printf("%-10s %10zu %10zu %10zu %10zu %10zu %14.2f\n", name, counts.records, counts.load, counts.sort,
+           counts.write, total, 1000.0 * total / max<size_t>(counts.records, 1));
+    return total;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        cerr << "Uso: " << argv[0] << " bitacora.txt [repeticiones máximas]" << endl;
+        return 1;
+    }
+    int maxRepetitions = argc > 2 ? atoi(argv[2]) : 64;
+    string input;
+    {
+        ifstream file(argv[1], ios::binary);
+        if (!file.is_open()) {
+            cerr << "Error al abrir el archivo: " << argv[1] << endl;
+            return 1;
+        }
+        input.assign(istreambuf_iterator<char>(file), istreambuf_iterator<char>());
+    }
+    if (!input.empty() && input.back() != '\n') input += '\n';
+
+    const string repeatedFile = "record_allocations_input.txt";
+    const string outputFile = "record_allocations_output.txt";
+    NullBuffer discard;
+    streambuf* console = cout.rdbuf();
+
+    // Casos cuya cantidad de reservas debe ser la misma en todas las repeticiones
+    struct Case {
+        const char* name;
+        StageCounts (*run)(const string&, const string&);
+        size_t first;
+        size_t last;
+    };
+    Case cases[] = {{"fijos", runFixedRecords, 0, 0}, {"act1.3", runAct13, 0, 0}, {"act2.3", runAct23, 0, 0}};
+
+    // Calentamiento: reservas únicas del programa
+    cout.rdbuf(&discard);
+    for (Case& current : cases) current.run(argv[1], outputFile);
+    cout.rdbuf(console);
+
+    printf("%-10s %10s %10s %10s %10s %10s %14s\n", "registros", "líneas", "carga", "orden", "escritura", "total",
+           "por 1000 lín.");
+    int lastRepetitions = 1;
+    for (int repetitions = 1; repetitions <= maxRepetitions; repetitions *= 4) {
+        {
+            ofstream file(repeatedFile, ios::binary);
+            for (int i = 0; i < repetitions; ++i) file << input;
+        }
+        printf("x%d\n", repetitions);
+        for (Case& current : cases) {
+            cout.rdbuf(&discard);
+            StageCounts counts = current.run(repeatedFile, outputFile);
+            cout.rdbuf(console);
+            current.last = printCounts(current.name, counts);
+            if (repetitions == 1) current.first = current.last;
+        }
+        lastRepetitions = repetitions;
+        printCounts("cadenas", runStringRecords(repeatedFile, outputFile));
+    }
+    remove(repeatedFile.c_str());
+    remove(outputFile.c_str());
+
+    bool constant = true;
+    for (const Case& current : cases) {
+        if (current.first != current.last) {
+            printf("ERROR: en %s las reservas cambiaron de %zu (x1) a %zu (x%d)\n", current.name, current.first,
+                   current.last, lastRepetitions);
+            constant = false;
+        } else {
+            printf("Reservas constantes en %s: %zu\n", current.name, current.first);
+        }
+    }
+    return constant ? 0 : 1;
+}
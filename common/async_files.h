@@ -0,0 +1,154 @@
+// Header con la carga y la escritura de archivos de las actividades (act1.3, act2.3)
+//
+// Con C++20 la E/S es asíncrona (common/async_io.h): la carga mantiene varias lecturas
+// en curso y el pipeline de loadParallel interpreta cada bloque en cuanto llega, y la
+// escritura da formato a un bloque mientras el anterior se escribe en el archivo. Con
+// C++17 las mismas funciones usan loadParallel y ofstream, así que los programas se
+// compilan igual con los dos estándares:
+//   g++ -std=c++20 -O2 -pthread act1.3.cpp -o act1.3   (E/S asíncrona)
+//   g++ -std=c++17 -O2 -pthread act1.3.cpp -o act1.3   (E/S bloqueante)
+// Definir BITACORA_IO_BLOQUEANTE antes de incluirlo usa la E/S bloqueante también con
+// C++20 (la asíncrona reserva memoria por cada bloque leído o escrito).
+#ifndef ASYNC_FILES_H
+#define ASYNC_FILES_H
+
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include "large_pages.h"
+#include "parallel_loader.h"
+
+#if defined(__cpp_impl_coroutine) && !defined(BITACORA_IO_BLOQUEANTE)
+#define ASYNC_FILES_USE_COROUTINES
+#include "async_io.h"
+#endif
+
+using namespace std;
+
+// Lecturas en curso por archivo y tamaño de cada bloque de escritura
+const unsigned ASYNC_READS_IN_FLIGHT = 4;
+const size_t ASYNC_WRITE_BLOCK = 1 << 20;
+
+#ifdef ASYNC_FILES_USE_COROUTINES
+
+/*
+ * Publica en el pipeline cada prefijo del archivo en cuanto terminan sus lecturas.
+ * Complejidad: O(n), donde n es el tamaño del archivo.
+ * @return false si alguna lectura falló.
+ */
+template <typename Publish>
+Task<bool> publishReads(AsyncReader& reader, Publish publish) {
+    bool ok = true;
+    while (ok && !reader.done()) {
+        ok = co_await reader.next();
+        if (ok) publish(reader.ready(), false);
+    }
+    co_await reader.finish();
+    publish(reader.ready(), true);
+    co_return ok;
+}
+
+/*
+ * Llena bloques con `fill` y los escribe con doble búfer: el grupo de hilos del ciclo da
+ * formato a un bloque mientras el anterior se escribe.
+ * Complejidad: O(n), donde n es el tamaño de la salida.
+ * @return false si el archivo no se pudo abrir o escribir.
+ */
+template <typename Fill>
+Task<bool> writeBlocksTask(IoLoop& loop, const string& filename, Fill& fill, size_t blockSize) {
+    AsyncWriter writer(loop);
+    if (!writer.open(filename)) co_return false;
+    bool ok = true, more = true;
+    while (more && ok) {
+        string& block = writer.buffer();
+        co_await loop.offload([&]() { more = fill(block, blockSize); });
+        ok = co_await writer.flush();
+    }
+    bool closed = co_await writer.close();
+    co_return ok && closed;
+}
+
+/*
+ * Carga un archivo de bitácora como loadParallel, pero el hilo productor lee con
+ * lecturas asíncronas (varias en curso) y publica cada bloque en cuanto termina, así
+ * que la lectura de los bloques siguientes se traslapa con la interpretación. Los
+ * archivos comprimidos se cargan con loadParallel.
+ * Complejidad: O(n), donde n es el tamaño del archivo, repartido entre los hilos.
+ * @param filename, buffer, parseLine, consume, threads, chunkSize Igual que en loadParallel.
+ * @return false si el archivo no se pudo abrir o leer.
+ */
+template <typename Record, typename Parser, typename Consumer>
+bool loadParallelAsync(const string& filename, LargeString& buffer, Parser parseLine, Consumer consume,
+                       unsigned threads = 0, size_t chunkSize = 4 << 20) {
+    // El ciclo solo atiende las lecturas; la interpretación es del pipeline
+    IoLoop loop(true, 1);
+    AsyncReader reader(loop, chunkSize, ASYNC_READS_IN_FLIGHT);
+    if (!reader.open(filename)) return false;
+    size_t size = reader.fileSize();
+
+    // Detectar si el archivo está comprimido
+    string header(min<size_t>(size, 18), '\0');
+    ssize_t headerBytes = header.empty() ? 0 : loop.wait(reader.read(&header[0], header.size(), 0));
+    if (headerBytes < 0) return false;
+    header.resize(headerBytes);
+    if (detectFormat(header) != InputFormat::Plain) {
+        reader.close();
+        return loadParallel<Record>(filename, buffer, parseLine, consume, threads, chunkSize);
+    }
+
+    if (threads == 0) threads = max(1u, thread::hardware_concurrency());
+    buffer.resize(size);
+    reader.start(&buffer[0]);
+    bool ok = true;
+    // El ciclo pasa al hilo productor, que es el único que lo usa mientras trabaja el pipeline
+    runPipeline<Record>(buffer, [&](auto publish) {
+        ok = loop.runTask(publishReads(reader, publish));
+    }, parseLine, consume, threads, chunkSize);
+    buffer.resize(reader.ready());
+    if (!ok) cerr << "Error al leer el archivo: " << filename << endl;
+    return ok;
+}
+
+/*
+ * Escribe un archivo por bloques: `fill(bloque, límite)` agrega registros al bloque
+ * hasta llegar al límite y regresa true si quedan registros por escribir. Se llama
+ * desde un hilo del ciclo, mientras se escribe el bloque anterior.
+ * Complejidad: O(n), donde n es el tamaño de la salida.
+ * @return false si el archivo no se pudo abrir o escribir.
+ */
+template <typename Fill>
+bool writeBlocksAsync(const string& filename, Fill fill, size_t blockSize = ASYNC_WRITE_BLOCK) {
+    IoLoop loop(true, 1);
+    return loop.runTask(writeBlocksTask(loop, filename, fill, blockSize));
+}
+
+#else
+
+// Sin C++20 (o con BITACORA_IO_BLOQUEANTE): las mismas funciones con E/S bloqueante
+
+template <typename Record, typename Parser, typename Consumer>
+bool loadParallelAsync(const string& filename, LargeString& buffer, Parser parseLine, Consumer consume,
+                       unsigned threads = 0, size_t chunkSize = 4 << 20) {
+    return loadParallel<Record>(filename, buffer, parseLine, consume, threads, chunkSize);
+}
+
+template <typename Fill>
+bool writeBlocksAsync(const string& filename, Fill fill, size_t blockSize = ASYNC_WRITE_BLOCK) {
+    ofstream file(filename, ios::binary);
+    if (!file.is_open()) return false;
+    string block;
+    block.reserve(blockSize + blockSize / 8); // El último registro puede pasar del límite
+    bool more = true;
+    while (more && file) {
+        block.clear();
+        more = fill(block, blockSize);
+        file.write(block.data(), block.size());
+    }
+    file.close();
+    return !file.fail();
+}
+
+#endif
+
+#endif
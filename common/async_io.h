@@ -0,0 +1,769 @@
+// Header para leer y escribir archivos de forma asíncrona con corrutinas de C++20
+//
+// Un IoLoop ejecuta corrutinas (Task) en un solo hilo. Las lecturas y escrituras se
+// envían al kernel con io_uring (con llamadas al sistema directas, sin liburing) y la
+// corrutina que las espera (co_await) se suspende hasta que terminan. Si io_uring no está
+// disponible (kernels anteriores a 5.6 o contenedores que lo bloquean) o si se pide con
+// BITACORA_IO=hilos, las operaciones se hacen con pread/pwrite en un grupo de hilos.
+// El trabajo de CPU (interpretar, ordenar, dar formato) se manda con offload() a otro
+// grupo de hilos, así que mientras una corrutina espera al disco otras interpretan u
+// ordenan sus archivos. AsyncReader lee un archivo por bloques con varias lecturas en
+// curso y AsyncWriter escribe con doble búfer.
+//
+// Requiere C++20 (g++ -std=c++20). Los demás headers de common/ siguen en C++17
+// (common/async_files.h usa este header solo cuando se compila con C++20).
+#ifndef ASYNC_IO_H
+#define ASYNC_IO_H
+
+#if !defined(__cpp_impl_coroutine)
+#error "common/async_io.h requiere C++20 (compilar con -std=c++20)"
+#endif
+
+#include <algorithm>
+#include <cerrno>
+#include <condition_variable>
+#include <coroutine>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+using namespace std;
+
+template <typename T = void>
+class Task;
+
+// Parte común de las promesas: la corrutina empieza suspendida y, al terminar, continúa
+// con la corrutina que la esperaba (transferencia simétrica, sin crecer la pila)
+struct TaskPromiseBase {
+    coroutine_handle<> continuation;
+
+    struct FinalAwaiter {
+        bool await_ready() noexcept { return false; }
+        template <typename Promise>
+        coroutine_handle<> await_suspend(coroutine_handle<Promise> handle) noexcept {
+            coroutine_handle<> next = handle.promise().continuation;
+            return next ? next : noop_coroutine();
+        }
+        void await_resume() noexcept {}
+    };
+
+    suspend_always initial_suspend() noexcept { return {}; }
+    FinalAwaiter final_suspend() noexcept { return {}; }
+    void unhandled_exception() { terminate(); }
+};
+
+template <typename T>
+struct TaskPromise : TaskPromiseBase {
+    T value{};
+
+    Task<T> get_return_object();
+    void return_value(T result) { value = move(result); }
+};
+
+template <>
+struct TaskPromise<void> : TaskPromiseBase {
+    Task<void> get_return_object();
+    void return_void() {}
+};
+
+/*
+ * Corrutina que produce un valor de tipo T. Empieza a ejecutarse cuando otra corrutina
+ * la espera con co_await (o cuando se entrega a IoLoop::spawn).
+ */
+template <typename T>
+class Task {
+public:
+    using promise_type = TaskPromise<T>;
+
+    explicit Task(coroutine_handle<promise_type> handle) : handle(handle) {}
+    Task(Task&& other) noexcept : handle(exchange(other.handle, nullptr)) {}
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+    Task& operator=(Task&&) = delete;
+    ~Task() {
+        if (handle) handle.destroy();
+    }
+
+    bool await_ready() const noexcept { return false; }
+    coroutine_handle<> await_suspend(coroutine_handle<> waiting) noexcept {
+        handle.promise().continuation = waiting;
+        return handle;
+    }
+    T await_resume() {
+        if constexpr (!is_void_v<T>) return move(handle.promise().value);
+    }
+
+private:
+    coroutine_handle<promise_type> handle;
+};
+
+template <typename T>
+Task<T> TaskPromise<T>::get_return_object() {
+    return Task<T>(coroutine_handle<TaskPromise<T>>::from_promise(*this));
+}
+
+inline Task<void> TaskPromise<void>::get_return_object() {
+    return Task<void>(coroutine_handle<TaskPromise<void>>::from_promise(*this));
+}
+
+// Estado de una operación en curso (lectura, escritura o trabajo en el grupo de hilos)
+struct IoOperationState {
+    ssize_t result = 0;        // Bytes transferidos, o -errno si falló
+    bool done = false;         // Solo lo modifica el hilo del IoLoop
+    coroutine_handle<> waiter; // Corrutina suspendida esperando el resultado
+};
+
+/*
+ * Operación ya enviada. Se espera con co_await, que regresa los bytes transferidos
+ * (pueden ser menos que los pedidos) o -errno. Toda operación debe esperarse antes de
+ * reutilizar o liberar su búfer.
+ */
+class IoOperation {
+private:
+    shared_ptr<IoOperationState> state;
+
+public:
+    IoOperation() {}
+    explicit IoOperation(shared_ptr<IoOperationState> state) : state(move(state)) {}
+
+    bool valid() const { return state != nullptr; }
+    bool ready() const { return state->done; }
+
+    bool await_ready() const noexcept { return state->done; }
+    void await_suspend(coroutine_handle<> waiting) noexcept { state->waiter = waiting; }
+    ssize_t await_resume() const noexcept { return state->result; }
+};
+
+// Grupo fijo de hilos que ejecuta tareas en orden de llegada
+class WorkerPool {
+private:
+    vector<thread> workers;
+    deque<function<void()>> tasks;
+    mutex lock;
+    condition_variable available;
+    bool stopping = false;
+
+public:
+    explicit WorkerPool(unsigned count) {
+        for (unsigned i = 0; i < max(1u, count); ++i) {
+            workers.emplace_back([this]() {
+                while (true) {
+                    function<void()> task;
+                    {
+                        unique_lock<mutex> guard(lock);
+                        available.wait(guard, [this]() { return stopping || !tasks.empty(); });
+                        if (tasks.empty()) return;
+                        task = move(tasks.front());
+                        tasks.pop_front();
+                    }
+                    task();
+                }
+            });
+        }
+    }
+
+    ~WorkerPool() {
+        {
+            lock_guard<mutex> guard(lock);
+            stopping = true;
+        }
+        available.notify_all();
+        for (thread& worker : workers) worker.join();
+    }
+
+    void post(function<void()> task) {
+        {
+            lock_guard<mutex> guard(lock);
+            tasks.push_back(move(task));
+        }
+        available.notify_one();
+    }
+};
+
+// Anillos de envío y de terminación de io_uring, proyectados desde el kernel
+class UringQueue {
+private:
+    int descriptor = -1;
+    void* sqRing = MAP_FAILED;
+    void* cqRing = MAP_FAILED;
+    size_t sqRingSize = 0;
+    size_t cqRingSize = 0;
+    io_uring_sqe* sqes = static_cast<io_uring_sqe*>(MAP_FAILED);
+    size_t sqesSize = 0;
+    unsigned* sqHead;
+    unsigned* sqTail;
+    unsigned* sqArray;
+    unsigned sqMask;
+    unsigned sqEntries;
+    unsigned* cqHead;
+    unsigned* cqTail;
+    unsigned cqMask;
+    io_uring_cqe* cqes;
+    unsigned localTail = 0;     // Entradas preparadas (algunas aún sin enviar)
+    unsigned pendingSubmit = 0; // Entradas preparadas que el kernel no ha recibido
+
+public:
+    UringQueue() {}
+    UringQueue(const UringQueue&) = delete;
+    UringQueue& operator=(const UringQueue&) = delete;
+
+    ~UringQueue() {
+        if (sqes != MAP_FAILED) munmap(sqes, sqesSize);
+        if (cqRing != MAP_FAILED && cqRing != sqRing) munmap(cqRing, cqRingSize);
+        if (sqRing != MAP_FAILED) munmap(sqRing, sqRingSize);
+        if (descriptor >= 0) close(descriptor);
+    }
+
+    /*
+     * Crea los anillos con `entries` entradas de envío.
+     * Complejidad: O(1).
+     * @return false si el kernel no soporta io_uring con lecturas y escrituras simples.
+     */
+    bool open(unsigned entries) {
+#ifdef __NR_io_uring_setup
+        io_uring_params params;
+        memset(&params, 0, sizeof(params));
+        descriptor = syscall(__NR_io_uring_setup, entries, &params);
+        // IORING_FEAT_RW_CUR_POS llegó junto con IORING_OP_READ e IORING_OP_WRITE (5.6)
+        if (descriptor < 0 || !(params.features & IORING_FEAT_RW_CUR_POS)) return false;
+
+        sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        bool singleMap = params.features & IORING_FEAT_SINGLE_MMAP;
+        if (singleMap) sqRingSize = cqRingSize = max(sqRingSize, cqRingSize);
+        sqRing = mmap(nullptr, sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, descriptor,
+                      IORING_OFF_SQ_RING);
+        if (sqRing == MAP_FAILED) return false;
+        cqRing = singleMap ? sqRing
+                           : mmap(nullptr, cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                                  descriptor, IORING_OFF_CQ_RING);
+        if (cqRing == MAP_FAILED) return false;
+        sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+        sqes = static_cast<io_uring_sqe*>(mmap(nullptr, sqesSize, PROT_READ | PROT_WRITE,
+                                               MAP_SHARED | MAP_POPULATE, descriptor, IORING_OFF_SQES));
+        if (sqes == MAP_FAILED) return false;
+
+        char* sq = static_cast<char*>(sqRing);
+        sqHead = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+        sqTail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        sqArray = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+        sqMask = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        sqEntries = params.sq_entries;
+        char* cq = static_cast<char*>(cqRing);
+        cqHead = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        cqTail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        cqMask = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+        localTail = *sqTail;
+        return true;
+#else
+        (void)entries;
+        return false;
+#endif
+    }
+
+    /*
+     * Entrada de envío libre (en ceros). Si el anillo está lleno, primero envía las preparadas.
+     * Complejidad: O(1).
+     */
+    io_uring_sqe* nextEntry() {
+        if (localTail - __atomic_load_n(sqHead, __ATOMIC_ACQUIRE) >= sqEntries) submit(0);
+        unsigned index = localTail & sqMask;
+        io_uring_sqe* entry = &sqes[index];
+        memset(entry, 0, sizeof(*entry));
+        sqArray[index] = index;
+        ++localTail;
+        ++pendingSubmit;
+        return entry;
+    }
+
+    /*
+     * Envía las entradas preparadas y espera a que haya al menos `waitFor` terminadas.
+     * Complejidad: O(1) más la espera.
+     */
+    void submit(unsigned waitFor) {
+        __atomic_store_n(sqTail, localTail, __ATOMIC_RELEASE);
+        while (true) {
+            int submitted = syscall(__NR_io_uring_enter, descriptor, pendingSubmit, waitFor,
+                                    waitFor ? IORING_ENTER_GETEVENTS : 0, nullptr, 0);
+            if (submitted >= 0) {
+                pendingSubmit -= submitted;
+                return;
+            }
+            if (errno != EINTR) return;
+        }
+    }
+
+    /*
+     * Entrega cada terminación disponible a `onCompletion(user_data, resultado)`.
+     * Complejidad: O(c), donde c es la cantidad de terminaciones.
+     */
+    template <typename OnCompletion>
+    void drain(OnCompletion onCompletion) {
+        unsigned head = *cqHead;
+        unsigned tail = __atomic_load_n(cqTail, __ATOMIC_ACQUIRE);
+        for (; head != tail; ++head) {
+            const io_uring_cqe& completion = cqes[head & cqMask];
+            onCompletion(completion.user_data, completion.res);
+        }
+        __atomic_store_n(cqHead, head, __ATOMIC_RELEASE);
+    }
+};
+
+/*
+ * Ciclo de eventos: ejecuta las corrutinas en el hilo que llama a run() y las reanuda
+ * cuando terminan sus operaciones. Las operaciones solo se envían desde ese hilo.
+ */
+class IoLoop {
+private:
+    const uint64_t WAKE_TAG = 0; // user_data de la lectura del eventfd
+
+    unique_ptr<UringQueue> ring;
+    unique_ptr<WorkerPool> ioPool;  // Respaldo de E/S sin io_uring
+    unique_ptr<WorkerPool> cpuPool; // Trabajo de offload()
+    int wakeDescriptor;             // eventfd con el que los hilos avisan que terminaron
+    uint64_t wakeValue = 0;
+    bool wakeArmed = false;
+    mutex completedLock;
+    vector<shared_ptr<IoOperationState>> completed; // Terminadas por los grupos de hilos
+    size_t inFlight = 0;
+    size_t activeTasks = 0;
+
+    // Corrutina raíz que se ejecuta sola y lleva la cuenta de las tareas activas
+    struct DetachedTask {
+        struct promise_type {
+            DetachedTask get_return_object() { return {}; }
+            suspend_never initial_suspend() noexcept { return {}; }
+            suspend_never final_suspend() noexcept { return {}; }
+            void return_void() {}
+            void unhandled_exception() { terminate(); }
+        };
+    };
+
+    static DetachedTask runDetached(Task<void> task, size_t& activeTasks) {
+        co_await task;
+        --activeTasks;
+    }
+
+    template <typename T>
+    static Task<void> storeResult(Task<T> task, T& result) {
+        result = co_await task;
+    }
+
+    // Marca una operación como terminada y reanuda a quien la espera (hilo del ciclo)
+    void finish(const shared_ptr<IoOperationState>& state) {
+        state->done = true;
+        --inFlight;
+        if (coroutine_handle<> waiter = exchange(state->waiter, nullptr)) waiter.resume();
+    }
+
+    // Registra una operación terminada en un grupo de hilos y despierta al ciclo
+    void postCompletion(shared_ptr<IoOperationState> state) {
+        {
+            lock_guard<mutex> guard(completedLock);
+            completed.push_back(move(state));
+        }
+        uint64_t one = 1;
+        while (::write(wakeDescriptor, &one, sizeof(one)) < 0 && errno == EINTR) {}
+    }
+
+    shared_ptr<IoOperationState> startOperation() {
+        ++inFlight;
+        return make_shared<IoOperationState>();
+    }
+
+    IoOperation transfer(bool isRead, int fd, char* data, size_t length, uint64_t offset) {
+        shared_ptr<IoOperationState> state = startOperation();
+        if (ring) {
+            io_uring_sqe* entry = ring->nextEntry();
+            entry->opcode = isRead ? IORING_OP_READ : IORING_OP_WRITE;
+            entry->fd = fd;
+            entry->addr = reinterpret_cast<uint64_t>(data);
+            entry->len = static_cast<uint32_t>(length);
+            entry->off = offset;
+            entry->user_data = reinterpret_cast<uint64_t>(new shared_ptr<IoOperationState>(state));
+        } else {
+            ioPool->post([this, state, isRead, fd, data, length, offset]() {
+                ssize_t result;
+                do {
+                    result = isRead ? pread(fd, data, length, offset) : pwrite(fd, data, length, offset);
+                } while (result < 0 && errno == EINTR);
+                state->result = result < 0 ? -errno : result;
+                postCompletion(state);
+            });
+        }
+        return IoOperation(state);
+    }
+
+    // Espera a que termine al menos una operación y reanuda las corrutinas correspondientes
+    void waitAndDispatch() {
+        if (ring) {
+            if (!wakeArmed) {
+                io_uring_sqe* entry = ring->nextEntry();
+                entry->opcode = IORING_OP_READ;
+                entry->fd = wakeDescriptor;
+                entry->addr = reinterpret_cast<uint64_t>(&wakeValue);
+                entry->len = sizeof(wakeValue);
+                entry->user_data = WAKE_TAG;
+                wakeArmed = true;
+            }
+            ring->submit(1);
+            // Primero se copian las terminaciones: las corrutinas reanudadas envían más operaciones
+            vector<pair<uint64_t, int>> events;
+            ring->drain([&events](uint64_t userData, int result) { events.push_back({userData, result}); });
+            for (const auto& event : events) {
+                if (event.first == WAKE_TAG) {
+                    wakeArmed = false;
+                    continue;
+                }
+                auto holder = reinterpret_cast<shared_ptr<IoOperationState>*>(event.first);
+                shared_ptr<IoOperationState> state = move(*holder);
+                delete holder;
+                state->result = event.second;
+                finish(state);
+            }
+        } else {
+            uint64_t value;
+            while (::read(wakeDescriptor, &value, sizeof(value)) < 0 && errno == EINTR) {}
+        }
+
+        vector<shared_ptr<IoOperationState>> ready;
+        {
+            lock_guard<mutex> guard(completedLock);
+            ready.swap(completed);
+        }
+        for (const shared_ptr<IoOperationState>& state : ready) finish(state);
+    }
+
+public:
+    /*
+     * Crea el ciclo. Usa io_uring si está disponible, salvo que `useUring` sea false o
+     * BITACORA_IO=hilos; si no, la E/S se hace en `ioThreads` hilos con pread/pwrite.
+     * @param cpuThreads Hilos para offload() (0 = uno por núcleo).
+     * @param ioThreads Hilos de E/S del respaldo.
+     */
+    explicit IoLoop(bool useUring = true, unsigned cpuThreads = 0, unsigned ioThreads = 4) {
+        const char* setting = getenv("BITACORA_IO");
+        if (setting && strcmp(setting, "hilos") == 0) useUring = false;
+        if (useUring) {
+            ring.reset(new UringQueue());
+            if (!ring->open(256)) ring.reset();
+        }
+        if (!ring) ioPool.reset(new WorkerPool(ioThreads));
+        if (cpuThreads == 0) cpuThreads = max(1u, thread::hardware_concurrency());
+        cpuPool.reset(new WorkerPool(cpuThreads));
+        wakeDescriptor = eventfd(0, EFD_CLOEXEC);
+    }
+
+    IoLoop(const IoLoop&) = delete;
+    IoLoop& operator=(const IoLoop&) = delete;
+
+    ~IoLoop() {
+        // Primero los hilos: sus tareas avisan al ciclo al terminar
+        ioPool.reset();
+        cpuPool.reset();
+        ring.reset();
+        close(wakeDescriptor);
+    }
+
+    // Nombre del mecanismo de E/S en uso
+    const char* backendName() const { return ring ? "io_uring" : "hilos"; }
+
+    /*
+     * Envía al kernel las operaciones preparadas sin esperar a que terminen (con io_uring
+     * se envían al esperar; esto sirve cuando el hilo va a hacer otro trabajo antes).
+     * Complejidad: O(1).
+     */
+    void submit() {
+        if (ring) ring->submit(0);
+    }
+
+    /*
+     * Envía una lectura de hasta `length` bytes (menos de 2 GB) desde `offset`.
+     * Complejidad: O(1).
+     */
+    IoOperation read(int fd, char* data, size_t length, uint64_t offset) {
+        return transfer(true, fd, data, length, offset);
+    }
+
+    /*
+     * Envía una escritura de hasta `length` bytes (menos de 2 GB) en `offset`.
+     * Complejidad: O(1).
+     */
+    IoOperation write(int fd, const char* data, size_t length, uint64_t offset) {
+        return transfer(false, fd, const_cast<char*>(data), length, offset);
+    }
+
+    /*
+     * Ejecuta `work` en el grupo de hilos de CPU; co_await regresa cuando termina.
+     * Mientras tanto el ciclo sigue atendiendo otras corrutinas.
+     * Complejidad: O(1) más el trabajo.
+     */
+    IoOperation offload(function<void()> work) {
+        shared_ptr<IoOperationState> state = startOperation();
+        cpuPool->post([this, state, work = move(work)]() {
+            work();
+            postCompletion(state);
+        });
+        return IoOperation(state);
+    }
+
+    /*
+     * Empieza a ejecutar una corrutina raíz (hasta su primera espera).
+     * Complejidad: la del tramo inicial de la corrutina.
+     */
+    void spawn(Task<void> task) {
+        ++activeTasks;
+        runDetached(move(task), activeTasks);
+    }
+
+    /*
+     * Atiende las operaciones hasta que terminen todas las corrutinas raíz. Una corrutina
+     * raíz activa siempre espera alguna operación; si no hay ninguna en curso, se suspendió
+     * con algo que el ciclo no puede reanudar (y esperar sería un bloqueo permanente), así
+     * que el programa termina con un mensaje también en compilaciones sin asserts.
+     * Complejidad: la del trabajo de las corrutinas.
+     */
+    void run() {
+        while (activeTasks > 0) {
+            if (inFlight == 0) {
+                cerr << "Error del ciclo de E/S: corrutina suspendida sin operaciones en curso" << endl;
+                abort();
+            }
+            waitAndDispatch();
+        }
+    }
+
+    /*
+     * Espera una sola operación desde código que no es corrutina, atendiendo mientras
+     * tanto las demás.
+     * Complejidad: la de la operación.
+     * @return Lo mismo que co_await sobre la operación.
+     */
+    ssize_t wait(IoOperation operation) {
+        while (!operation.ready()) waitAndDispatch();
+        return operation.await_resume();
+    }
+
+    /*
+     * Ejecuta una corrutina hasta que termina y regresa su resultado, para usar la E/S
+     * asíncrona desde funciones normales.
+     * Complejidad: la del trabajo de la corrutina.
+     */
+    template <typename T>
+    T runTask(Task<T> task) {
+        T result{};
+        spawn(storeResult(move(task), result));
+        run();
+        return result;
+    }
+};
+
+/*
+ * Lector por bloques: mantiene varias lecturas en curso sobre un destino del tamaño del
+ * archivo y entrega los bloques en orden, así que quien lo usa interpreta lo ya leído
+ * mientras el kernel lee los bloques siguientes.
+ */
+class AsyncReader {
+private:
+    IoLoop& loop;
+    size_t blockSize;
+    unsigned readsInFlight;
+    int descriptor = -1;
+    size_t size = 0;
+    char* data = nullptr;
+    deque<IoOperation> reads; // Lecturas en curso, en orden de posición
+    deque<size_t> lengths;
+    size_t nextRead = 0;
+    size_t readyEnd = 0;
+
+    // Envía lecturas hasta tener `readsInFlight` en curso
+    void issueReads() {
+        while (reads.size() < readsInFlight && nextRead < size) {
+            size_t length = min(blockSize, size - nextRead);
+            reads.push_back(loop.read(descriptor, data + nextRead, length, nextRead));
+            lengths.push_back(length);
+            nextRead += length;
+        }
+        loop.submit();
+    }
+
+public:
+    AsyncReader(IoLoop& loop, size_t blockSize = 4 << 20, unsigned readsInFlight = 4)
+        : loop(loop), blockSize(max<size_t>(blockSize, 1)), readsInFlight(max(readsInFlight, 1u)) {}
+    AsyncReader(const AsyncReader&) = delete;
+    AsyncReader& operator=(const AsyncReader&) = delete;
+    ~AsyncReader() { close(); }
+
+    /*
+     * Abre el archivo y obtiene su tamaño.
+     * @return false si no se pudo abrir.
+     */
+    bool open(const string& filename) {
+        close();
+        descriptor = ::open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+        if (descriptor < 0) return false;
+        struct stat status;
+        if (fstat(descriptor, &status) != 0) {
+            close();
+            return false;
+        }
+        size = status.st_size;
+        return true;
+    }
+
+    // Cierra el archivo (las lecturas en curso deben haberse esperado con finish())
+    void close() {
+        if (descriptor >= 0) ::close(descriptor);
+        descriptor = -1;
+    }
+
+    size_t fileSize() const { return size; }
+
+    // Lectura suelta (por ejemplo, del encabezado) fuera de los bloques
+    IoOperation read(char* destination, size_t length, uint64_t offset) {
+        return loop.read(descriptor, destination, length, offset);
+    }
+
+    // Fija el destino de los bloques (fileSize() bytes que no se mueven hasta finish())
+    void start(char* destination) { data = destination; }
+
+    // Fin del prefijo del archivo que ya está en el destino
+    size_t ready() const { return readyEnd; }
+    bool done() const { return readyEnd == size; }
+
+    /*
+     * Espera el siguiente bloque en orden, reenviando lo que falte si la lectura fue
+     * parcial, y deja en curso las lecturas de los bloques siguientes.
+     * @return false si una lectura falló o el archivo se acortó.
+     */
+    Task<bool> next() {
+        issueReads();
+        if (reads.empty()) co_return true;
+        ssize_t received = co_await reads.front();
+        size_t expected = lengths.front();
+        reads.pop_front();
+        lengths.pop_front();
+        while (received >= 0 && static_cast<size_t>(received) < expected) {
+            ssize_t more = co_await loop.read(descriptor, data + readyEnd + received, expected - received,
+                                              readyEnd + received);
+            if (more <= 0) co_return false;
+            received += more;
+        }
+        if (received < 0) co_return false;
+        readyEnd += expected;
+        issueReads();
+        co_return true;
+    }
+
+    // Espera las lecturas que sigan en curso (escriben en el destino) antes de liberarlo
+    Task<void> finish() {
+        for (IoOperation& pending : reads) co_await pending;
+        reads.clear();
+        lengths.clear();
+    }
+};
+
+/*
+ * Escritor con doble búfer: mientras un bloque se escribe en el archivo, el programa
+ * llena el otro. flush() espera solo a la escritura anterior del bloque que va a reutilizar.
+ */
+class AsyncWriter {
+private:
+    IoLoop& loop;
+    int descriptor = -1;
+    uint64_t offset = 0;
+    string blocks[2];
+    IoOperation pending[2];
+    uint64_t starts[2] = {0, 0};
+    size_t written[2] = {0, 0};
+    int current = 0;
+
+    // Espera la escritura de un bloque, reenviando lo que falte si fue parcial
+    Task<bool> complete(int slot) {
+        while (pending[slot].valid()) {
+            ssize_t result = co_await pending[slot];
+            pending[slot] = IoOperation();
+            if (result <= 0) co_return false;
+            written[slot] += result;
+            if (written[slot] < blocks[slot].size()) {
+                pending[slot] = loop.write(descriptor, blocks[slot].data() + written[slot],
+                                           blocks[slot].size() - written[slot], starts[slot] + written[slot]);
+            }
+        }
+        co_return true;
+    }
+
+public:
+    explicit AsyncWriter(IoLoop& loop) : loop(loop) {}
+    AsyncWriter(const AsyncWriter&) = delete;
+    AsyncWriter& operator=(const AsyncWriter&) = delete;
+    ~AsyncWriter() {
+        if (descriptor >= 0) ::close(descriptor);
+    }
+
+    /*
+     * Crea (o vacía) el archivo de salida.
+     * @return false si no se pudo abrir.
+     */
+    bool open(const string& filename) {
+        descriptor = ::open(filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        return descriptor >= 0;
+    }
+
+    // Bloque que se está llenando
+    string& buffer() { return blocks[current]; }
+
+    /*
+     * Envía el bloque actual a escribir y cambia al otro bloque, esperando a que termine
+     * su escritura anterior.
+     * @return false si alguna escritura falló.
+     */
+    Task<bool> flush() {
+        int slot = current;
+        if (!blocks[slot].empty()) {
+            starts[slot] = offset;
+            written[slot] = 0;
+            pending[slot] = loop.write(descriptor, blocks[slot].data(), blocks[slot].size(), offset);
+            offset += blocks[slot].size();
+        }
+        current = 1 - current;
+        bool ok = co_await complete(current);
+        blocks[current].clear();
+        co_return ok;
+    }
+
+    /*
+     * Escribe lo pendiente, espera todas las escrituras y cierra el archivo.
+     * @return false si alguna escritura falló.
+     */
+    Task<bool> close() {
+        bool ok = co_await flush();
+        bool first = co_await complete(0);
+        bool second = co_await complete(1);
+        ::close(descriptor);
+        descriptor = -1;
+        co_return ok && first && second;
+    }
+};
+
+#endif
@@ -0,0 +1,286 @@
+// Header para construir en paralelo el grafo puerto -> atacantes en formato CSR
+//
+// Cada hilo recorre una parte de los registros y agrega sus aristas (puerto, atacante)
+// a un búfer propio, sin candados; después los búferes se ordenan y se mezclan en
+// paralelo, se eliminan las aristas repetidas y se arma el grafo como arreglos
+// contiguos (CSR): los vecinos del puerto i están en neighbours[offsets[i], offsets[i+1]).
+// Los atacantes se identifican por su clave numérica de IP y puerto, así que no se
+// reservan cadenas ni se consultan árboles por cada línea.
+#ifndef ATTACK_GRAPH_H
+#define ATTACK_GRAPH_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+// Marcas de una arista (se combinan con OR al unir aristas repetidas)
+const uint8_t EDGE_ADMIN_ATTEMPT = 1; // El atacante intentó acceder como admin
+// Arista del último intento como admin de su puerto, en el orden de la bitácora (al unir
+// grafos se conserva solo la del último grafo que la tenga en ese puerto)
+const uint8_t EDGE_LAST_ADMIN_ATTEMPT = 2;
+
+// Arista del grafo: un atacante (IP y puerto como clave numérica) hacia un puerto atacado
+struct AttackEdge {
+    int port;
+    unsigned long long attacker;
+    uint8_t flags;
+
+    bool operator<(const AttackEdge& other) const {
+        return port != other.port ? port < other.port : attacker < other.attacker;
+    }
+};
+
+// Vista de solo lectura de un grafo CSR, ya sea en memoria o proyectado desde un archivo
+struct AttackGraphView {
+    size_t portCount;
+    size_t edgeCount;
+    size_t attackerCount;
+    const int* ports;
+    const uint32_t* offsets;
+    const uint32_t* neighbours;
+    const unsigned long long* attackers;
+    const uint8_t* edgeFlags;
+
+    /*
+     * Cantidad de atacantes distintos del puerto en la posición `index`.
+     * Complejidad: O(1).
+     */
+    size_t fanOut(size_t index) const { return offsets[index + 1] - offsets[index]; }
+
+    /*
+     * Posición de un puerto en el grafo.
+     * Complejidad: O(log p), donde p es la cantidad de puertos.
+     * @return Posición del puerto, o -1 si no fue atacado.
+     */
+    long findPort(int port) const {
+        const int* it = lower_bound(ports, ports + portCount, port);
+        return it != ports + portCount && *it == port ? it - ports : -1;
+    }
+};
+
+// Grafo puerto -> atacantes distintos en formato CSR
+struct AttackGraph {
+    vector<int> ports;                    // Puertos atacados, en orden ascendente
+    vector<uint32_t> offsets;             // Inicio de los vecinos de cada puerto (ports.size() + 1 valores)
+    vector<uint32_t> neighbours;          // Índices en `attackers`, ordenados dentro de cada puerto
+    vector<unsigned long long> attackers; // Diccionario de atacantes, en orden ascendente
+    vector<uint8_t> edgeFlags;            // Marcas de cada arista (EDGE_ADMIN_ATTEMPT, ...)
+
+    /*
+     * Cantidad de atacantes distintos del puerto en la posición `index`.
+     * Complejidad: O(1).
+     */
+    size_t fanOut(size_t index) const { return offsets[index + 1] - offsets[index]; }
+
+    /*
+     * Posición de un puerto en el grafo.
+     * Complejidad: O(log p), donde p es la cantidad de puertos.
+     * @return Posición del puerto, o -1 si no fue atacado.
+     */
+    long findPort(int port) const {
+        auto it = lower_bound(ports.begin(), ports.end(), port);
+        return it != ports.end() && *it == port ? it - ports.begin() : -1;
+    }
+
+    // Vista de solo lectura del grafo (válida mientras el grafo no cambie)
+    AttackGraphView view() const {
+        return {ports.size(), neighbours.size(), attackers.size(), ports.data(), offsets.data(),
+                neighbours.data(), attackers.data(), edgeFlags.data()};
+    }
+};
+
+/*
+ * Ejecuta `task(id)` para id = 0 .. count - 1 y espera a que terminen. Las tareas se
+ * reparten entre a lo más un hilo por núcleo (uno de ellos es el hilo que llama): cada
+ * hilo toma la siguiente tarea pendiente, así que `count` puede ser mayor que los núcleos.
+ * Complejidad: O(s / h), donde s es la suma de las tareas y h la cantidad de hilos.
+ */
+template <typename Task>
+void runThreads(unsigned count, Task task) {
+    unsigned workerCount = min(count, max(1u, thread::hardware_concurrency()));
+    atomic<unsigned> next(0);
+    auto work = [&]() {
+        for (unsigned id = next++; id < count; id = next++) task(id);
+    };
+    vector<thread> workers;
+    for (unsigned i = 0; i + 1 < workerCount; ++i) workers.emplace_back(work);
+    if (count > 0) work();
+    for (thread& worker : workers) worker.join();
+}
+
+/*
+ * Mezcla en paralelo tramos consecutivos ya ordenados: en cada ronda se mezclan pares
+ * de tramos vecinos, repartidos entre los hilos de runThreads.
+ * Complejidad: O(n log r), donde r es la cantidad de tramos.
+ * @param values Arreglo con los tramos.
+ * @param bounds Límites de los tramos (el tramo i es [bounds[i], bounds[i + 1])).
+ */
+template <typename T>
+void mergeSortedRuns(vector<T>& values, vector<size_t> bounds) {
+    while (bounds.size() > 2) {
+        size_t pairs = (bounds.size() - 1) / 2;
+        runThreads(pairs, [&](unsigned pair) {
+            inplace_merge(values.begin() + bounds[2 * pair], values.begin() + bounds[2 * pair + 1],
+                          values.begin() + bounds[2 * pair + 2]);
+        });
+
+        vector<size_t> merged;
+        for (size_t i = 0; i < bounds.size(); i += 2) merged.push_back(bounds[i]);
+        if (merged.back() != bounds.back()) merged.push_back(bounds.back());
+        bounds = merged;
+    }
+}
+
+/*
+ * Ordena un arreglo en paralelo: cada hilo ordena un tramo y después se mezclan.
+ * Complejidad: O((n / t) log n + n log t), donde t es la cantidad de hilos.
+ */
+template <typename T>
+void parallelSort(vector<T>& values, unsigned threads) {
+    unsigned parts = max(1u, threads);
+    vector<size_t> bounds(parts + 1);
+    for (unsigned i = 0; i <= parts; ++i) bounds[i] = values.size() * i / parts;
+    runThreads(parts, [&](unsigned id) { sort(values.begin() + bounds[id], values.begin() + bounds[id + 1]); });
+    mergeSortedRuns(values, bounds);
+}
+
+/*
+ * Junta las aristas repetidas de un arreglo ordenado, combinando sus marcas.
+ * Complejidad: O(n).
+ */
+inline void mergeDuplicateEdges(vector<AttackEdge>& edges) {
+    size_t kept = 0;
+    for (size_t i = 0; i < edges.size(); ++i) {
+        if (kept > 0 && edges[kept - 1].port == edges[i].port && edges[kept - 1].attacker == edges[i].attacker) {
+            edges[kept - 1].flags |= edges[i].flags;
+        } else {
+            edges[kept++] = edges[i];
+        }
+    }
+    edges.resize(kept);
+}
+
+/*
+ * Arma los arreglos CSR a partir de aristas ordenadas y sin repetir.
+ * Complejidad: O((n / t) log n + n log t), donde n es la cantidad de aristas y t la de hilos.
+ */
+inline AttackGraph assembleAttackGraph(const vector<AttackEdge>& edges, unsigned threads) {
+    // Diccionario de atacantes
+    AttackGraph graph;
+    graph.attackers.resize(edges.size());
+    for (size_t i = 0; i < edges.size(); ++i) graph.attackers[i] = edges[i].attacker;
+    parallelSort(graph.attackers, threads);
+    graph.attackers.erase(unique(graph.attackers.begin(), graph.attackers.end()), graph.attackers.end());
+
+    // Arreglos CSR; los índices de los vecinos se buscan en paralelo
+    graph.edgeFlags.resize(edges.size());
+    for (size_t i = 0; i < edges.size(); ++i) {
+        if (i == 0 || edges[i].port != edges[i - 1].port) {
+            graph.ports.push_back(edges[i].port);
+            graph.offsets.push_back(i);
+        }
+        graph.edgeFlags[i] = edges[i].flags;
+    }
+    graph.offsets.push_back(edges.size());
+
+    graph.neighbours.resize(edges.size());
+    runThreads(threads, [&](unsigned id) {
+        size_t end = edges.size() * (id + 1) / threads;
+        for (size_t i = edges.size() * id / threads; i < end; ++i) {
+            graph.neighbours[i] =
+                lower_bound(graph.attackers.begin(), graph.attackers.end(), edges[i].attacker) - graph.attackers.begin();
+        }
+    });
+    return graph;
+}
+
+/*
+ * Construye el grafo puerto -> atacantes distintos a partir de los registros.
+ * Complejidad: O((n / t) log n + n log t), donde n es la cantidad de registros y t la de hilos.
+ * @param records Registros cargados (vector o LargeVector).
+ * @param edgeOf Función `bool(const Record&, AttackEdge&)`; regresa false si el registro no
+ *               aporta una arista (por ejemplo, fuera del horario analizado).
+ * @param threads Cantidad de hilos (0 para usar todos los núcleos).
+ */
+template <typename Records, typename EdgeOf>
+AttackGraph buildAttackGraph(const Records& records, EdgeOf edgeOf, unsigned threads = 0) {
+    if (threads == 0) threads = max(1u, thread::hardware_concurrency());
+
+    // Aristas de cada hilo en su propio búfer, ya ordenadas y sin repetir
+    vector<vector<AttackEdge>> local(threads);
+    runThreads(threads, [&](unsigned id) {
+        vector<AttackEdge>& edges = local[id];
+        size_t end = records.size() * (id + 1) / threads;
+        for (size_t i = records.size() * id / threads; i < end; ++i) {
+            AttackEdge edge;
+            if (edgeOf(records[i], edge)) edges.push_back(edge);
+        }
+        sort(edges.begin(), edges.end());
+        mergeDuplicateEdges(edges);
+    });
+
+    // Concatenar los búferes (cada hilo copia el suyo) y mezclarlos
+    vector<size_t> bounds(threads + 1, 0);
+    for (unsigned id = 0; id < threads; ++id) bounds[id + 1] = bounds[id] + local[id].size();
+    vector<AttackEdge> edges(bounds[threads]);
+    runThreads(threads, [&](unsigned id) {
+        copy(local[id].begin(), local[id].end(), edges.begin() + bounds[id]);
+        vector<AttackEdge>().swap(local[id]);
+    });
+    mergeSortedRuns(edges, bounds);
+    mergeDuplicateEdges(edges);
+    return assembleAttackGraph(edges, threads);
+}
+
+/*
+ * Une varios grafos (por ejemplo, de días distintos, en orden) sin volver a interpretar las
+ * bitácoras. Las aristas de cada grafo ya están ordenadas por (puerto, atacante), así que
+ * solo se mezclan.
+ * Complejidad: O(n log g + g p), donde n es el total de aristas, g la cantidad de grafos y
+ * p la de puertos.
+ */
+inline AttackGraph unionAttackGraphs(const vector<AttackGraphView>& graphs, unsigned threads = 0) {
+    if (threads == 0) threads = max(1u, thread::hardware_concurrency());
+
+    // Puertos cuyo último intento como admin está en un grafo posterior a cada grafo
+    vector<vector<int>> laterAdminPorts(graphs.size());
+    vector<int> seen;
+    for (size_t id = graphs.size(); id-- > 0;) {
+        laterAdminPorts[id] = seen;
+        const AttackGraphView& graph = graphs[id];
+        for (size_t port = 0; port < graph.portCount; ++port) {
+            for (uint32_t i = graph.offsets[port]; i < graph.offsets[port + 1]; ++i) {
+                if (graph.edgeFlags[i] & EDGE_LAST_ADMIN_ATTEMPT) seen.push_back(graph.ports[port]);
+            }
+        }
+        sort(seen.begin(), seen.end());
+        seen.erase(unique(seen.begin(), seen.end()), seen.end());
+    }
+
+    vector<size_t> bounds(1, 0);
+    for (const AttackGraphView& graph : graphs) bounds.push_back(bounds.back() + graph.edgeCount);
+    vector<AttackEdge> edges(bounds.back());
+    runThreads(graphs.size(), [&](unsigned id) {
+        const AttackGraphView& graph = graphs[id];
+        const vector<int>& later = laterAdminPorts[id];
+        size_t next = bounds[id];
+        for (size_t port = 0; port < graph.portCount; ++port) {
+            uint8_t keep = binary_search(later.begin(), later.end(), graph.ports[port])
+                               ? uint8_t(~EDGE_LAST_ADMIN_ATTEMPT) : uint8_t(0xFF);
+            for (uint32_t i = graph.offsets[port]; i < graph.offsets[port + 1]; ++i) {
+                edges[next++] = {graph.ports[port], graph.attackers[graph.neighbours[i]],
+                                 uint8_t(graph.edgeFlags[i] & keep)};
+            }
+        }
+    });
+    mergeSortedRuns(edges, bounds);
+    mergeDuplicateEdges(edges);
+    return assembleAttackGraph(edges, threads);
+}
+
+#endif
@@ -0,0 +1,207 @@
+// Header para guardar el grafo de ataques en disco y proyectarlo con mmap
+//
+// Formato (versión 2, cada sección alineada a 8 bytes):
+//   encabezado    GraphFileHeader (firma, versión, marca de orden de bytes y tamaños)
+//   ports         int32[portCount]          puertos atacados en orden ascendente
+//   offsets       uint32[portCount + 1]     inicio de los vecinos de cada puerto
+//   attackers     uint64[attackerCount]     diccionario de atacantes (IP y puerto)
+//   neighbours    uint32[edgeCount]         índices en attackers
+//   edgeFlags     uint8[edgeCount]          marcas de cada arista
+// Como el archivo tiene la misma forma que el grafo en memoria, cargarlo solo proyecta
+// el archivo y apunta a sus secciones: las consultas empiezan sin interpretar nada.
+// Por lo mismo los enteros quedan en el orden de bytes de la máquina que escribió el
+// archivo; la marca GRAPH_FILE_BYTE_ORDER permite rechazar un archivo de una máquina con
+// el orden contrario en lugar de leer valores invertidos.
+#ifndef ATTACK_GRAPH_FILE_H
+#define ATTACK_GRAPH_FILE_H
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "attack_graph.h"
+
+using namespace std;
+
+const char GRAPH_FILE_MAGIC[8] = {'G', 'R', 'A', 'F', 'O', 'A', 'T', 'Q'};
+const uint32_t GRAPH_FILE_VERSION = 2;
+const uint32_t GRAPH_FILE_BYTE_ORDER = 0x01020304; // Se lee igual solo con el mismo orden de bytes
+
+struct GraphFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t headerSize;
+    uint32_t byteOrder;
+    uint32_t reserved;
+    uint64_t portCount;
+    uint64_t edgeCount;
+    uint64_t attackerCount;
+};
+
+// Posición de cada sección dentro del archivo
+struct GraphFileLayout {
+    size_t ports;
+    size_t offsets;
+    size_t attackers;
+    size_t neighbours;
+    size_t edgeFlags;
+    size_t totalSize;
+};
+
+/*
+ * Redondea una posición al siguiente múltiplo de 8.
+ * Complejidad: O(1).
+ */
+inline size_t alignTo8(size_t position) { return (position + 7) & ~size_t(7); }
+
+/*
+ * Calcula la posición de las secciones a partir de los tamaños del encabezado.
+ * Complejidad: O(1).
+ */
+inline GraphFileLayout graphFileLayout(const GraphFileHeader& header) {
+    GraphFileLayout layout;
+    layout.ports = alignTo8(sizeof(GraphFileHeader));
+    layout.offsets = alignTo8(layout.ports + header.portCount * sizeof(int32_t));
+    layout.attackers = alignTo8(layout.offsets + (header.portCount + 1) * sizeof(uint32_t));
+    layout.neighbours = alignTo8(layout.attackers + header.attackerCount * sizeof(uint64_t));
+    layout.edgeFlags = layout.neighbours + header.edgeCount * sizeof(uint32_t);
+    layout.totalSize = layout.edgeFlags + header.edgeCount;
+    return layout;
+}
+
+/*
+ * Guarda un grafo en el formato binario.
+ * Complejidad: O(p + n + a), el tamaño del grafo.
+ * @return false si no se pudo escribir el archivo.
+ */
+inline bool saveAttackGraph(const AttackGraphView& graph, const string& filename) {
+    static_assert(sizeof(int) == sizeof(int32_t) && sizeof(unsigned long long) == sizeof(uint64_t),
+                  "El formato requiere enteros de 32 bits y claves de 64 bits");
+    GraphFileHeader header = {};
+    memcpy(header.magic, GRAPH_FILE_MAGIC, sizeof(header.magic));
+    header.version = GRAPH_FILE_VERSION;
+    header.byteOrder = GRAPH_FILE_BYTE_ORDER;
+    header.headerSize = sizeof(GraphFileHeader);
+    header.portCount = graph.portCount;
+    header.edgeCount = graph.edgeCount;
+    header.attackerCount = graph.attackerCount;
+    GraphFileLayout layout = graphFileLayout(header);
+
+    ofstream file(filename, ios::binary | ios::trunc);
+    if (!file.is_open()) return false;
+    auto writeAt = [&file](size_t position, const void* data, size_t size) {
+        static const char padding[8] = {};
+        size_t current = file.tellp();
+        file.write(padding, position - current);
+        file.write(static_cast<const char*>(data), size);
+    };
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    writeAt(layout.ports, graph.ports, graph.portCount * sizeof(int32_t));
+    writeAt(layout.offsets, graph.offsets, (graph.portCount + 1) * sizeof(uint32_t));
+    writeAt(layout.attackers, graph.attackers, graph.attackerCount * sizeof(uint64_t));
+    writeAt(layout.neighbours, graph.neighbours, graph.edgeCount * sizeof(uint32_t));
+    writeAt(layout.edgeFlags, graph.edgeFlags, graph.edgeCount);
+    return file.good();
+}
+
+/*
+ * Grafo proyectado en memoria desde un archivo (solo lectura). Abrirlo solo recorre los
+ * límites y los índices de vecinos para validarlos; no se copia ni se interpreta nada, y
+ * el diccionario de atacantes y las marcas se leen del disco hasta que una consulta los usa.
+ */
+class MappedAttackGraph {
+private:
+    void* data;
+    size_t size;
+    AttackGraphView graph;
+
+    // Revisa que los arreglos CSR sean coherentes entre sí
+    bool contentValid() const {
+        if (graph.offsets[0] != 0 || graph.offsets[graph.portCount] != graph.edgeCount) return false;
+        for (size_t i = 0; i < graph.portCount; ++i) {
+            if (graph.offsets[i] > graph.offsets[i + 1]) return false;
+            if (i > 0 && graph.ports[i - 1] >= graph.ports[i]) return false;
+        }
+        for (size_t i = 0; i < graph.edgeCount; ++i) {
+            if (graph.neighbours[i] >= graph.attackerCount) return false;
+        }
+        return true;
+    }
+
+public:
+    MappedAttackGraph() : data(nullptr), size(0), graph() {}
+    ~MappedAttackGraph() { close(); }
+    MappedAttackGraph(const MappedAttackGraph&) = delete;
+    MappedAttackGraph& operator=(const MappedAttackGraph&) = delete;
+
+    /*
+     * Proyecta un archivo y valida su encabezado, su tamaño y su contenido (puertos en
+     * orden, límites de vecinos que no decrecen e índices de atacantes dentro del
+     * diccionario), para que las consultas no lean fuera de las secciones.
+     * Complejidad: O(p + n), donde p es la cantidad de puertos y n la de aristas.
+     * @return false si el archivo no existe, no es un grafo, es de otra versión o de una
+     *         máquina con otro orden de bytes, o está dañado.
+     */
+    bool open(const string& filename) {
+        close();
+        int descriptor = ::open(filename.c_str(), O_RDONLY);
+        if (descriptor < 0) return false;
+        struct stat status;
+        if (fstat(descriptor, &status) != 0 || static_cast<size_t>(status.st_size) < sizeof(GraphFileHeader)) {
+            ::close(descriptor);
+            return false;
+        }
+        size = status.st_size;
+        data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+        ::close(descriptor);
+        if (data == MAP_FAILED) {
+            data = nullptr;
+            return false;
+        }
+
+        const GraphFileHeader* header = static_cast<const GraphFileHeader*>(data);
+        bool valid = memcmp(header->magic, GRAPH_FILE_MAGIC, sizeof(header->magic)) == 0 &&
+                     header->byteOrder == GRAPH_FILE_BYTE_ORDER && header->version == GRAPH_FILE_VERSION &&
+                     header->headerSize == sizeof(GraphFileHeader) &&
+                     header->portCount < size && header->edgeCount < size && header->attackerCount < size;
+        GraphFileLayout layout = graphFileLayout(*header);
+        if (!valid || layout.totalSize != size) {
+            close();
+            return false;
+        }
+
+        const char* base = static_cast<const char*>(data);
+        graph.portCount = header->portCount;
+        graph.edgeCount = header->edgeCount;
+        graph.attackerCount = header->attackerCount;
+        graph.ports = reinterpret_cast<const int*>(base + layout.ports);
+        graph.offsets = reinterpret_cast<const uint32_t*>(base + layout.offsets);
+        graph.attackers = reinterpret_cast<const unsigned long long*>(base + layout.attackers);
+        graph.neighbours = reinterpret_cast<const uint32_t*>(base + layout.neighbours);
+        graph.edgeFlags = reinterpret_cast<const uint8_t*>(base + layout.edgeFlags);
+        if (!contentValid()) {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    // Libera la proyección
+    void close() {
+        if (data) munmap(data, size);
+        data = nullptr;
+        size = 0;
+        graph = AttackGraphView();
+    }
+
+    // Vista del grafo (válida mientras el archivo esté abierto)
+    const AttackGraphView& view() const { return graph; }
+};
+
+#endif
@@ -0,0 +1,419 @@
+// Header para leer bitácoras comprimidas con gzip/bgzip o zstd
+//
+// El soporte de cada formato se activa al compilar:
+//   -DUSE_ZLIB -lz      gzip y bgzip (BGZF)
+//   -DUSE_ZSTD -lzstd   zstd
+// Sin estas banderas los archivos comprimidos se detectan pero se rechazan.
+#ifndef COMPRESSED_INPUT_H
+#define COMPRESSED_INPUT_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef USE_ZLIB
+#include <zlib.h>
+#endif
+#ifdef USE_ZSTD
+#include <zstd.h>
+#endif
+
+using namespace std;
+
+enum class InputFormat { Plain, Gzip, Bgzf, Zstd };
+
+// Bloque comprimido independiente y su posición dentro del resultado descomprimido.
+struct CompressedBlock {
+    size_t inputOffset;
+    size_t inputSize;
+    size_t outputOffset;
+    size_t outputSize;
+};
+
+/*
+ * Lee un entero little-endian de `bytes` bytes.
+ * Complejidad: O(1).
+ */
+inline size_t readLittleEndian(const string& data, size_t pos, int bytes) {
+    size_t value = 0;
+    for (int i = bytes - 1; i >= 0; --i) {
+        value = (value << 8) | static_cast<unsigned char>(data[pos + i]);
+    }
+    return value;
+}
+
+/*
+ * Detecta el formato de un archivo por sus primeros bytes.
+ * Complejidad: O(1).
+ * @param header Primeros bytes del archivo.
+ * @return Formato detectado (Plain si no es un formato comprimido conocido).
+ */
+inline InputFormat detectFormat(const string& header) {
+    if (header.size() >= 4 && header.compare(0, 4, "\x28\xb5\x2f\xfd") == 0) {
+        return InputFormat::Zstd;
+    }
+    if (header.size() >= 18 && header.compare(0, 2, "\x1f\x8b") == 0) {
+        // BGZF: miembro gzip con el subcampo extra "BC" que guarda el tamaño del bloque
+        bool extra = (static_cast<unsigned char>(header[3]) & 4) != 0;
+        if (extra && readLittleEndian(header, 10, 2) == 6 && header[12] == 'B' && header[13] == 'C') {
+            return InputFormat::Bgzf;
+        }
+        return InputFormat::Gzip;
+    }
+    if (header.size() >= 2 && header.compare(0, 2, "\x1f\x8b") == 0) {
+        return InputFormat::Gzip;
+    }
+    return InputFormat::Plain;
+}
+
+/*
+ * Indica si el soporte para un formato fue compilado.
+ * Complejidad: O(1).
+ */
+inline bool formatSupported(InputFormat format) {
+    switch (format) {
+        case InputFormat::Plain: return true;
+#ifdef USE_ZLIB
+        case InputFormat::Gzip: case InputFormat::Bgzf: return true;
+#endif
+#ifdef USE_ZSTD
+        case InputFormat::Zstd: return true;
+#endif
+        default: return false;
+    }
+}
+
+/*
+ * Obtiene la tabla de bloques independientes de un archivo comprimido, sin descomprimirlo.
+ * Solo es posible para BGZF (cada bloque guarda su tamaño comprimido y descomprimido)
+ * y para zstd cuando todas las tramas declaran su tamaño descomprimido.
+ * Complejidad: O(b), donde b es la cantidad de bloques.
+ * @param format Formato del archivo.
+ * @param input Contenido comprimido.
+ * @param blocks Tabla de bloques resultante.
+ * @param totalSize Tamaño total descomprimido.
+ * @return false si el archivo no está dividido en bloques de tamaño conocido.
+ */
+inline bool findBlocks(InputFormat format, const string& input, vector<CompressedBlock>& blocks, size_t& totalSize) {
+    blocks.clear();
+    totalSize = 0;
+    size_t pos = 0;
+
+    if (format == InputFormat::Bgzf) {
+        while (pos < input.size()) {
+            if (input.size() - pos < 26 || detectFormat(input.substr(pos, 18)) != InputFormat::Bgzf) {
+                return false;
+            }
+            size_t blockSize = readLittleEndian(input, pos + 16, 2) + 1;
+            if (blockSize < 26 || pos + blockSize > input.size()) return false;
+            size_t outputSize = readLittleEndian(input, pos + blockSize - 4, 4);
+            blocks.push_back({pos, blockSize, totalSize, outputSize});
+            totalSize += outputSize;
+            pos += blockSize;
+        }
+        return true;
+    }
+
+#ifdef USE_ZSTD
+    if (format == InputFormat::Zstd) {
+        while (pos < input.size()) {
+            size_t frameSize = ZSTD_findFrameCompressedSize(input.data() + pos, input.size() - pos);
+            unsigned long long outputSize = ZSTD_getFrameContentSize(input.data() + pos, input.size() - pos);
+            if (ZSTD_isError(frameSize) || outputSize == ZSTD_CONTENTSIZE_UNKNOWN ||
+                outputSize == ZSTD_CONTENTSIZE_ERROR) {
+                return false;
+            }
+            blocks.push_back({pos, frameSize, totalSize, static_cast<size_t>(outputSize)});
+            totalSize += outputSize;
+            pos += frameSize;
+        }
+        return true;
+    }
+#endif
+    return false;
+}
+
+/*
+ * Descomprime un bloque independiente en su posición del resultado.
+ * Complejidad: O(k), donde k es el tamaño del bloque.
+ * @return false si el bloque está dañado o el formato no fue compilado.
+ */
+inline bool decompressBlock(InputFormat format, const string& input, const CompressedBlock& block, char* output) {
+#ifdef USE_ZLIB
+    if (format == InputFormat::Bgzf) {
+        z_stream stream = {};
+        if (inflateInit2(&stream, 16 + MAX_WBITS) != Z_OK) return false;
+        stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(input.data() + block.inputOffset));
+        stream.avail_in = block.inputSize;
+        stream.next_out = reinterpret_cast<Bytef*>(output + block.outputOffset);
+        stream.avail_out = block.outputSize;
+        int result = inflate(&stream, Z_FINISH);
+        bool ok = result == Z_STREAM_END && stream.avail_out == 0;
+        inflateEnd(&stream);
+        return ok;
+    }
+#endif
+#ifdef USE_ZSTD
+    if (format == InputFormat::Zstd) {
+        size_t result = ZSTD_decompress(output + block.outputOffset, block.outputSize,
+                                        input.data() + block.inputOffset, block.inputSize);
+        return !ZSTD_isError(result) && result == block.outputSize;
+    }
+#endif
+    (void)format; (void)input; (void)block; (void)output;
+    return false;
+}
+
+/*
+ * Descomprime bloques independientes en paralelo. Los hilos toman bloques en orden y
+ * `onReady(fin)` se llama en el hilo que invoca cada vez que el prefijo [0, fin) del
+ * resultado queda completo, para que otra etapa pueda empezar a procesarlo.
+ * Complejidad: O(n / t), donde n es el tamaño del resultado y t la cantidad de hilos.
+ * @param output Memoria de destino con al menos el tamaño total descomprimido.
+ * @return false si algún bloque no se pudo descomprimir.
+ */
+template <typename OnReady>
+bool decompressParallel(InputFormat format, const string& input, const vector<CompressedBlock>& blocks,
+                        char* output, unsigned threads, OnReady onReady) {
+    unique_ptr<atomic<int>[]> state(new atomic<int>[blocks.size()]); // 0 pendiente, 1 listo, 2 error
+    for (size_t i = 0; i < blocks.size(); ++i) state[i].store(0, memory_order_relaxed);
+    atomic<size_t> nextBlock(0);
+    atomic<bool> failed(false);
+
+    vector<thread> workers;
+    for (unsigned t = 0; t < max(1u, threads); ++t) {
+        workers.emplace_back([&]() {
+            for (size_t i = nextBlock++; i < blocks.size() && !failed; i = nextBlock++) {
+                bool ok = decompressBlock(format, input, blocks[i], output);
+                if (!ok) failed = true;
+                state[i].store(ok ? 1 : 2, memory_order_release);
+            }
+        });
+    }
+
+    bool ok = true;
+    for (size_t i = 0; i < blocks.size() && ok; ++i) {
+        int value;
+        while ((value = state[i].load(memory_order_acquire)) == 0 && !failed) this_thread::yield();
+        if (value != 1) {
+            ok = false;
+            break;
+        }
+        onReady(blocks[i].outputOffset + blocks[i].outputSize);
+    }
+
+    for (thread& worker : workers) worker.join();
+    return ok;
+}
+
+// Resultado de StreamDecompressor::run
+enum class StreamStatus { NeedInput, NeedOutput, Done, Error };
+
+/*
+ * Descompresor de un solo flujo (gzip de uno o varios miembros, o zstd sin tamaños
+ * declarados) que recibe la entrada por tramos y escribe el resultado directamente en la
+ * memoria que indique quien llama, para que cada tramo pueda interpretarse en cuanto sale.
+ * Los datos que siguen al último miembro o trama y no empiezan otro (por ejemplo, relleno
+ * con ceros) se ignoran, igual que hace gzip.
+ */
+class StreamDecompressor {
+private:
+    InputFormat format;
+    string input;             // Entrada recibida; lo anterior a inputPos ya se consumió
+    size_t inputPos = 0;
+    bool lastInput = false;   // Ya no llegará más entrada
+    bool betweenMembers = false; // Terminó un miembro o trama y falta ver si sigue otro
+    bool ready = false;
+    bool done = false;
+#ifdef USE_ZLIB
+    z_stream zlibStream = {};
+#endif
+#ifdef USE_ZSTD
+    ZSTD_DStream* zstdStream = nullptr;
+#endif
+
+    // Indica si la entrada pendiente empieza con la firma de otro miembro gzip o trama zstd
+    bool nextMemberFollows() const {
+        const unsigned char* next = reinterpret_cast<const unsigned char*>(input.data() + inputPos);
+        if (format == InputFormat::Zstd) {
+            bool frame = next[0] == 0x28 && next[1] == 0xb5 && next[2] == 0x2f && next[3] == 0xfd;
+            bool skippable = (next[0] & 0xf0) == 0x50 && next[1] == 0x2a && next[2] == 0x4d && next[3] == 0x18;
+            return frame || skippable;
+        }
+        return next[0] == 0x1f && next[1] == 0x8b;
+    }
+
+    // Avanza la descompresión una vez; `ended` indica que terminó un miembro o trama.
+    // Regresa false si los datos están dañados.
+    bool step(const char* in, size_t inSize, char* out, size_t outSize,
+              size_t& consumed, size_t& produced, bool& ended) {
+        consumed = produced = 0;
+        ended = false;
+#ifdef USE_ZLIB
+        if (format == InputFormat::Gzip || format == InputFormat::Bgzf) {
+            zlibStream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(in));
+            zlibStream.avail_in = static_cast<uInt>(min<size_t>(inSize, 1u << 30));
+            zlibStream.next_out = reinterpret_cast<Bytef*>(out);
+            zlibStream.avail_out = static_cast<uInt>(min<size_t>(outSize, 1u << 30));
+            uInt inBefore = zlibStream.avail_in, outBefore = zlibStream.avail_out;
+            int result = inflate(&zlibStream, Z_NO_FLUSH);
+            consumed = inBefore - zlibStream.avail_in;
+            produced = outBefore - zlibStream.avail_out;
+            ended = result == Z_STREAM_END;
+            return result == Z_OK || result == Z_STREAM_END || result == Z_BUF_ERROR;
+        }
+#endif
+#ifdef USE_ZSTD
+        if (format == InputFormat::Zstd) {
+            ZSTD_inBuffer inBuffer = {in, inSize, 0};
+            ZSTD_outBuffer outBuffer = {out, outSize, 0};
+            size_t result = ZSTD_decompressStream(zstdStream, &outBuffer, &inBuffer);
+            consumed = inBuffer.pos;
+            produced = outBuffer.pos;
+            ended = result == 0;
+            return !ZSTD_isError(result);
+        }
+#endif
+        (void)in; (void)inSize; (void)out; (void)outSize;
+        return false;
+    }
+
+public:
+    /*
+     * Constructor del descompresor.
+     * @param format Formato del flujo (si no fue compilado, run regresa Error).
+     */
+    explicit StreamDecompressor(InputFormat format) : format(format) {
+#ifdef USE_ZLIB
+        if (format == InputFormat::Gzip || format == InputFormat::Bgzf) {
+            ready = inflateInit2(&zlibStream, 16 + MAX_WBITS) == Z_OK;
+        }
+#endif
+#ifdef USE_ZSTD
+        if (format == InputFormat::Zstd) {
+            zstdStream = ZSTD_createDStream();
+            ready = zstdStream && !ZSTD_isError(ZSTD_initDStream(zstdStream));
+        }
+#endif
+    }
+
+    ~StreamDecompressor() {
+#ifdef USE_ZLIB
+        if (ready && (format == InputFormat::Gzip || format == InputFormat::Bgzf)) inflateEnd(&zlibStream);
+#endif
+#ifdef USE_ZSTD
+        if (zstdStream) ZSTD_freeDStream(zstdStream);
+#endif
+    }
+
+    StreamDecompressor(const StreamDecompressor&) = delete;
+    StreamDecompressor& operator=(const StreamDecompressor&) = delete;
+
+    /*
+     * Agrega un tramo de entrada comprimida (se copia, así que puede reutilizarse después).
+     * Complejidad: O(k), donde k es el tamaño del tramo más la entrada pendiente.
+     * @param last true si es el último tramo del archivo.
+     */
+    void feed(const char* data, size_t size, bool last) {
+        input.erase(0, inputPos);
+        inputPos = 0;
+        input.append(data, size);
+        lastInput = last;
+    }
+
+    /*
+     * Descomprime en [output, output + capacity) tanto como permitan la entrada recibida y
+     * la memoria disponible.
+     * Complejidad: O(k), donde k es la cantidad de bytes producidos.
+     * @param written Bytes escritos en `output`.
+     * @return NeedInput si falta entrada (llamar feed), NeedOutput si se llenó `output`,
+     *         Done al terminar el último miembro o trama, o Error si los datos están dañados
+     *         o truncados.
+     */
+    StreamStatus run(char* output, size_t capacity, size_t& written) {
+        written = 0;
+        if (!ready) return StreamStatus::Error;
+        while (!done) {
+            size_t available = input.size() - inputPos;
+            if (betweenMembers) {
+                size_t magic = format == InputFormat::Zstd ? 4 : 2;
+                if (available < magic && !lastInput) return StreamStatus::NeedInput;
+                if (available < magic || !nextMemberFollows()) {
+                    done = true; // Datos sobrantes después del último miembro: se ignoran
+                    break;
+                }
+                betweenMembers = false;
+#ifdef USE_ZLIB
+                if (format != InputFormat::Zstd) inflateReset(&zlibStream);
+#endif
+            }
+            if (written == capacity) return StreamStatus::NeedOutput;
+            if (available == 0 && !lastInput) return StreamStatus::NeedInput;
+
+            size_t consumed, produced;
+            bool ended;
+            if (!step(input.data() + inputPos, available, output + written, capacity - written,
+                      consumed, produced, ended)) {
+                return StreamStatus::Error;
+            }
+            inputPos += consumed;
+            written += produced;
+            if (ended) {
+                betweenMembers = true;
+            } else if (consumed == 0 && produced == 0) {
+                // Sin avance con espacio disponible: falta entrada o el archivo está truncado
+                return lastInput ? StreamStatus::Error : StreamStatus::NeedInput;
+            }
+        }
+        return StreamStatus::Done;
+    }
+};
+
+/*
+ * Estima el tamaño descomprimido de un flujo para reservar el resultado de una vez.
+ * En gzip los últimos 4 bytes guardan el tamaño del último miembro (módulo 2^32), que es
+ * exacto en archivos de un solo miembro; si no alcanza se supone una razón de 4 a 1.
+ * Complejidad: O(1).
+ * @param inputSize Tamaño del archivo comprimido.
+ * @param trailer Últimos 4 bytes del archivo.
+ */
+inline size_t estimateStreamSize(InputFormat format, size_t inputSize, const string& trailer) {
+    size_t estimate = 4 * inputSize + (1 << 16);
+    if (format != InputFormat::Zstd && trailer.size() == 4) {
+        estimate = max(estimate, readLittleEndian(trailer, 0, 4) + (1 << 16));
+    }
+    return estimate;
+}
+
+/*
+ * Descomprime un archivo completo como un solo flujo (ver StreamDecompressor), haciendo
+ * crecer el resultado según se necesite.
+ * @param output Cadena de destino (string o una con otro asignador).
+ * Complejidad: O(n), donde n es el tamaño descomprimido.
+ * @return false si el archivo está dañado o el formato no fue compilado.
+ */
+template <typename Output>
+bool decompressStream(InputFormat format, const string& input, Output& output) {
+    StreamDecompressor stream(format);
+    stream.feed(input.data(), input.size(), true);
+    string trailer = input.size() >= 4 ? input.substr(input.size() - 4) : string();
+    output.resize(estimateStreamSize(format, input.size(), trailer));
+    size_t written = 0;
+    while (true) {
+        size_t produced;
+        StreamStatus status = stream.run(&output[written], output.size() - written, produced);
+        written += produced;
+        if (status != StreamStatus::NeedOutput) {
+            output.resize(written);
+            return status == StreamStatus::Done;
+        }
+        output.resize(2 * output.size());
+    }
+}
+
+#endif
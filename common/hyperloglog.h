@@ -0,0 +1,168 @@
+// Header con un estimador de cardinalidad HyperLogLog
+//
+// Estima cuántos elementos distintos se agregaron usando 2^p registros de un byte, sin
+// guardar los elementos. El error estándar relativo es 1.04 / sqrt(2^p): por ejemplo,
+// con p = 12 se usan 4 KB y el error típico es de 1.6%. Mientras hay pocos elementos se
+// usa una representación dispersa (solo los registros ocupados), así que un conjunto
+// pequeño ocupa pocos bytes aunque la precisión sea alta.
+#ifndef HYPERLOGLOG_H
+#define HYPERLOGLOG_H
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+using namespace std;
+
+// Precisiones aceptadas (bits del índice de registro)
+const int HLL_MIN_PRECISION = 4;
+const int HLL_MAX_PRECISION = 16;
+const int HLL_DEFAULT_PRECISION = 12;
+
+/*
+ * Mezcla los bits de un entero de 64 bits (finalizador de MurmurHash3).
+ * Complejidad: O(1).
+ */
+inline uint64_t mixHash(uint64_t value) {
+    value ^= value >> 33;
+    value *= 0xFF51AFD7ED558CCDULL;
+    value ^= value >> 33;
+    value *= 0xC4CEB9FE1A85EC53ULL;
+    value ^= value >> 33;
+    return value;
+}
+
+/*
+ * Hash de 64 bits de un texto (FNV-1a seguido de mixHash).
+ * Complejidad: O(k), donde k es la longitud del texto.
+ */
+inline uint64_t hashBytes(const char* data, size_t length) {
+    uint64_t hash = 0xCBF29CE484222325ULL;
+    for (size_t i = 0; i < length; ++i) {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= 0x100000001B3ULL;
+    }
+    return mixHash(hash);
+}
+
+class HyperLogLog {
+private:
+    int precision;
+    vector<uint8_t> registers; // Representación densa (vacía mientras se usa la dispersa)
+    vector<uint32_t> sparse;   // Registros ocupados como (índice << 8) | valor
+
+    // Cantidad de registros
+    size_t registerCount() const { return size_t(1) << precision; }
+
+    // Máximo de registros ocupados antes de pasar a la representación densa (a lo más 4 KB)
+    size_t sparseLimit() const { return registerCount() / 16 < 1024 ? registerCount() / 16 : 1024; }
+
+    /*
+     * Pasa de la representación dispersa a la densa.
+     * Complejidad: O(m), donde m es la cantidad de registros.
+     */
+    void toDense() {
+        registers.assign(registerCount(), 0);
+        for (uint32_t entry : sparse) registers[entry >> 8] = entry & 0xFF;
+        sparse.clear();
+        sparse.shrink_to_fit();
+    }
+
+    /*
+     * Actualiza un registro con el máximo entre su valor y `rank`.
+     * Complejidad: O(1) en la representación densa, O(s) en la dispersa (s <= 1024 registros).
+     */
+    void update(uint32_t index, uint8_t rank) {
+        if (!registers.empty()) {
+            if (rank > registers[index]) registers[index] = rank;
+            return;
+        }
+        for (uint32_t& entry : sparse) {
+            if (entry >> 8 == index) {
+                if (rank > (entry & 0xFF)) entry = (index << 8) | rank;
+                return;
+            }
+        }
+        sparse.push_back((index << 8) | rank);
+        if (sparse.size() > sparseLimit()) toDense();
+    }
+
+public:
+    /*
+     * Complejidad: O(1).
+     * @param precision Bits del índice de registro (entre HLL_MIN_PRECISION y HLL_MAX_PRECISION).
+     */
+    explicit HyperLogLog(int precision = HLL_DEFAULT_PRECISION)
+        : precision(precision < HLL_MIN_PRECISION ? HLL_MIN_PRECISION
+                    : precision > HLL_MAX_PRECISION ? HLL_MAX_PRECISION : precision) {}
+
+    /*
+     * Agrega un elemento a partir de su hash de 64 bits.
+     * Complejidad: O(1) amortizado.
+     */
+    void addHash(uint64_t hash) {
+        uint32_t index = hash >> (64 - precision);
+        // Posición del primer bit encendido después del índice; el bit centinela la limita
+        uint8_t rank = __builtin_clzll((hash << precision) | (1ULL << (precision - 1))) + 1;
+        update(index, rank);
+    }
+
+    /*
+     * Agrega un texto.
+     * Complejidad: O(k), donde k es la longitud del texto.
+     */
+    void add(const char* data, size_t length) { addHash(hashBytes(data, length)); }
+
+    /*
+     * Combina otro estimador con la misma precisión (unión de los conjuntos).
+     * Complejidad: O(m).
+     */
+    void merge(const HyperLogLog& other) {
+        if (other.registers.empty()) {
+            for (uint32_t entry : other.sparse) update(entry >> 8, entry & 0xFF);
+            return;
+        }
+        if (registers.empty()) toDense();
+        for (size_t i = 0; i < registers.size(); ++i) {
+            if (other.registers[i] > registers[i]) registers[i] = other.registers[i];
+        }
+    }
+
+    /*
+     * Estima la cantidad de elementos distintos agregados.
+     * Usa conteo lineal (registros vacíos) cuando la estimación es pequeña.
+     * Complejidad: O(m) en la representación densa, O(1) en la dispersa.
+     */
+    double estimate() const {
+        double m = registerCount();
+        if (registers.empty()) {
+            // Con pocos registros ocupados el conteo lineal es la estimación más precisa
+            return m * log(m / (m - sparse.size()));
+        }
+
+        double sum = 0;
+        size_t zeros = 0;
+        for (uint8_t value : registers) {
+            sum += ldexp(1.0, -value);
+            zeros += value == 0;
+        }
+        double alpha = precision == 4 ? 0.673 : precision == 5 ? 0.697 : precision == 6 ? 0.709
+                                                                         : 0.7213 / (1 + 1.079 / m);
+        double raw = alpha * m * m / sum;
+        if (raw <= 2.5 * m && zeros > 0) return m * log(m / zeros);
+        return raw;
+    }
+
+    // Error estándar relativo esperado de la estimación
+    double standardError() const { return 1.04 / sqrt(static_cast<double>(registerCount())); }
+
+    // Bytes usados por los registros
+    size_t memoryBytes() const {
+        return registers.capacity() * sizeof(uint8_t) + sparse.capacity() * sizeof(uint32_t);
+    }
+
+    int getPrecision() const { return precision; }
+};
+
+#endif
@@ -0,0 +1,221 @@
+// Header para reservar los arreglos grandes de la bitácora con páginas grandes y
+// repartirlos entre los nodos NUMA
+//
+// Las búsquedas binarias y los sondeos de tablas sobre arreglos de cientos de MB tocan
+// una página distinta en casi cada acceso, así que con páginas de 4 KB el costo lo
+// dominan las fallas del TLB. Las reservas grandes se hacen con mmap, en este orden:
+//   - páginas grandes explícitas (MAP_HUGETLB), si el sistema tiene páginas reservadas;
+//   - páginas grandes transparentes (madvise(MADV_HUGEPAGE)) sobre una región alineada a 2 MB;
+//   - páginas normales.
+// Cada paso cae al siguiente si el sistema no lo permite, así que el programa funciona
+// igual en cualquier máquina. La política se elige con setPagePolicy() o con la variable
+// de entorno BITACORA_PAGINAS (normales, transparentes o explicitas).
+//
+// En máquinas con varios nodos NUMA, todas las reservas grandes (los arreglos de registros
+// y el búfer con el texto de la bitácora) se intercalan entre los nodos (mbind con
+// MPOL_INTERLEAVE): los lee cualquier hilo, así que se busca la misma latencia promedio
+// desde todos los nodos en lugar de ubicar cada tramo junto al hilo que lo llenó.
+#ifndef LARGE_PAGES_H
+#define LARGE_PAGES_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+using namespace std;
+
+const size_t HUGE_PAGE_SIZE = 2 << 20;
+const size_t LARGE_ALLOCATION_THRESHOLD = 1 << 20; // Las reservas menores usan operator new
+const int MEMORY_POLICY_INTERLEAVE = 3;            // MPOL_INTERLEAVE de <numaif.h>
+
+// Tipo de página que se pide para las reservas grandes
+enum class PagePolicy { Normal, Transparent, Explicit };
+
+// Bytes reservados con cada tipo de página (para los reportes y el benchmark)
+struct LargePageStats {
+    atomic<size_t> explicitBytes{0};
+    atomic<size_t> transparentBytes{0};
+    atomic<size_t> normalBytes{0};
+};
+
+inline LargePageStats& largePageStats() {
+    static LargePageStats stats;
+    return stats;
+}
+
+/*
+ * Política inicial: la de BITACORA_PAGINAS, o páginas explícitas con sus respaldos.
+ * Complejidad: O(1).
+ */
+inline PagePolicy defaultPagePolicy() {
+    const char* value = getenv("BITACORA_PAGINAS");
+    if (value && strcmp(value, "normales") == 0) return PagePolicy::Normal;
+    if (value && strcmp(value, "transparentes") == 0) return PagePolicy::Transparent;
+    return PagePolicy::Explicit;
+}
+
+inline atomic<PagePolicy>& pagePolicySetting() {
+    static atomic<PagePolicy> policy(defaultPagePolicy());
+    return policy;
+}
+
+inline PagePolicy pagePolicy() { return pagePolicySetting().load(memory_order_relaxed); }
+inline void setPagePolicy(PagePolicy policy) { pagePolicySetting().store(policy, memory_order_relaxed); }
+
+/*
+ * Máscara de los nodos NUMA en línea (según /sys), uno por bit.
+ * Complejidad: O(1); se lee una sola vez.
+ * @return 1 (solo el nodo 0) si el sistema no expone la información.
+ */
+inline unsigned long onlineNodeMask() {
+    static const unsigned long mask = []() {
+        unsigned long nodes = 0;
+        ifstream file("/sys/devices/system/node/online");
+        string list;
+        if (!(file >> list)) return 1ul;
+        // Formato "0", "0-3" o "0,2-3"
+        size_t position = 0;
+        while (position < list.size()) {
+            size_t end = list.find(',', position);
+            if (end == string::npos) end = list.size();
+            string range = list.substr(position, end - position);
+            size_t dash = range.find('-');
+            int first = atoi(range.c_str());
+            int last = dash == string::npos ? first : atoi(range.c_str() + dash + 1);
+            for (int node = first; node <= last && node < 64; ++node) nodes |= 1ul << node;
+            position = end + 1;
+        }
+        return nodes ? nodes : 1ul;
+    }();
+    return mask;
+}
+
+/*
+ * Cantidad de nodos NUMA en línea.
+ * Complejidad: O(1).
+ */
+inline int numaNodeCount() { return __builtin_popcountl(onlineNodeMask()); }
+
+/*
+ * Intercala las páginas (aún sin tocar) de una región entre todos los nodos NUMA, para que
+ * los hilos de todos los nodos lean un arreglo compartido con la misma latencia promedio.
+ * Sin efecto en máquinas de un solo nodo o si el kernel no soporta mbind.
+ * Complejidad: O(1).
+ */
+inline void interleaveAcrossNodes(void* data, size_t bytes) {
+#ifdef SYS_mbind
+    if (numaNodeCount() < 2) return;
+    unsigned long mask = onlineNodeMask();
+    syscall(SYS_mbind, data, bytes, MEMORY_POLICY_INTERLEAVE, &mask, sizeof(mask) * 8, 0);
+#else
+    (void)data;
+    (void)bytes;
+#endif
+}
+
+/*
+ * Redondea un tamaño al siguiente múltiplo de la página grande.
+ * Complejidad: O(1).
+ */
+inline size_t roundToHugePage(size_t bytes) { return (bytes + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1); }
+
+/*
+ * Reserva una región grande según la política vigente (ver el inicio del archivo).
+ * La región queda alineada a 2 MB y sin tocar.
+ * Complejidad: O(1); las páginas se asignan al tocarse.
+ * @return nullptr si no hay memoria.
+ */
+inline void* allocateLarge(size_t bytes) {
+    size_t length = roundToHugePage(bytes);
+    PagePolicy policy = pagePolicy();
+    LargePageStats& stats = largePageStats();
+
+    if (policy == PagePolicy::Explicit) {
+        void* data = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (data != MAP_FAILED) {
+            stats.explicitBytes += length;
+            interleaveAcrossNodes(data, length);
+            return data;
+        }
+    }
+
+    // Región alineada a 2 MB: se reserva de más y se recortan los extremos
+    void* raw = mmap(nullptr, length + HUGE_PAGE_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (raw == MAP_FAILED) return nullptr;
+    char* start = static_cast<char*>(raw);
+    char* aligned = reinterpret_cast<char*>(roundToHugePage(reinterpret_cast<uintptr_t>(start)));
+    if (aligned > start) munmap(start, aligned - start);
+    munmap(aligned + length, start + HUGE_PAGE_SIZE - aligned);
+
+    // Con la política normal se piden páginas de 4 KB aunque el sistema use THP siempre
+    if (policy != PagePolicy::Normal && madvise(aligned, length, MADV_HUGEPAGE) == 0) {
+        stats.transparentBytes += length;
+    } else {
+        madvise(aligned, length, MADV_NOHUGEPAGE);
+        stats.normalBytes += length;
+    }
+    interleaveAcrossNodes(aligned, length);
+    return aligned;
+}
+
+/*
+ * Libera una región de allocateLarge (con el mismo tamaño con el que se pidió).
+ * Complejidad: O(1).
+ */
+inline void releaseLarge(void* data, size_t bytes) {
+    if (data) munmap(data, roundToHugePage(bytes));
+}
+
+/*
+ * Asignador para los arreglos grandes: las reservas desde LARGE_ALLOCATION_THRESHOLD usan
+ * allocateLarge y las menores, operator new.
+ */
+template <typename T>
+struct LargePageAllocator {
+    using value_type = T;
+
+    LargePageAllocator() {}
+    template <typename U>
+    LargePageAllocator(const LargePageAllocator<U>&) {}
+
+    T* allocate(size_t count) {
+        size_t bytes = count * sizeof(T);
+        if (bytes < LARGE_ALLOCATION_THRESHOLD) return allocator<T>().allocate(count);
+        void* data = allocateLarge(bytes);
+        if (!data) throw bad_alloc();
+        return static_cast<T*>(data);
+    }
+
+    void deallocate(T* pointer, size_t count) {
+        size_t bytes = count * sizeof(T);
+        if (bytes < LARGE_ALLOCATION_THRESHOLD) allocator<T>().deallocate(pointer, count);
+        else releaseLarge(pointer, bytes);
+    }
+};
+
+template <typename T, typename U>
+bool operator==(const LargePageAllocator<T>&, const LargePageAllocator<U>&) { return true; }
+template <typename T, typename U>
+bool operator!=(const LargePageAllocator<T>&, const LargePageAllocator<U>&) { return false; }
+
+// Arreglo contiguo que se reserva con LargePageAllocator cuando es grande
+template <typename T>
+using LargeVector = vector<T, LargePageAllocator<T>>;
+
+// Texto contiguo que se reserva con LargePageAllocator cuando es grande (el búfer con el
+// contenido de la bitácora, al que apuntan los registros)
+using LargeString = basic_string<char, char_traits<char>, LargePageAllocator<char>>;
+
+#endif
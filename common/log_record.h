@@ -0,0 +1,207 @@
+// Header con el registro de bitácora que comparten el programa de análisis y el servicio de consultas
+//
+// Cada línea se interpreta una sola vez con todas las claves numéricas (fecha, IP y puerto);
+// los campos de texto se guardan como segmentos del búfer con el archivo completo.
+#ifndef LOG_RECORD_H
+#define LOG_RECORD_H
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "large_pages.h"
+#include "log_tokenizer.h"
+#include "parallel_loader.h"
+
+using namespace std;
+
+// Segmento (posición, longitud) dentro del búfer con el archivo de entrada
+struct Span {
+    size_t offset;
+    size_t length;
+};
+
+// Registro interpretado una sola vez y compartido por todas las etapas o consultas.
+// Los campos de texto son segmentos del búfer; las claves numéricas sirven para ordenar.
+struct Record {
+    Span month;
+    Span day;
+    Span time;
+    Span ip;       // IP con puerto
+    Span message;
+    int monthNumber;
+    int dayNumber;
+    int timestamp; // Segundos desde el inicio del año
+    unsigned long long ipKey; // Octetos de 10 bits y puerto de 16 bits (igual que act2.3)
+    int port;
+    int hour;
+};
+
+// Registros cargados y el búfer al que hacen referencia (solo lectura una vez cargados).
+// El búfer y los registros se reservan con páginas grandes (ver common/large_pages.h).
+struct LogStore {
+    LargeString buffer;
+    LargeVector<Record> records;
+
+    string_view view(Span span) const {
+        return string_view(buffer.data() + span.offset, span.length);
+    }
+};
+
+// Días transcurridos antes de cada mes (1-12), en un año bisiesto
+const int DAYS_BEFORE_MONTH[13] = {0, 0, 31, 60, 91, 121, 152, 182, 213, 244, 274, 305, 335};
+
+/*
+ * Calcula la fecha en segundos, la hora, la clave de IP y el puerto de un registro cuyos
+ * segmentos, mes y día ya se conocen.
+ * Complejidad: O(1).
+ * @param line Inicio del búfer al que apuntan los segmentos.
+ * @param lineEnd Fin de la línea dentro del búfer.
+ */
+inline void computeRecordKeys(const char* line, size_t lineEnd, Record& record) {
+    int minute = 0, second = 0;
+    parseClock(line + record.time.offset, record.time.length, record.hour, minute, second);
+    int dayOfYear = DAYS_BEFORE_MONTH[record.monthNumber] + record.dayNumber - 1;
+    record.timestamp = ((dayOfYear * 24 + record.hour) * 60 + minute) * 60 + second;
+
+    int octets[4];
+    parseIPPort(line + record.ip.offset, line + lineEnd, octets, record.port);
+    record.ipKey = 0;
+    for (int octet = 0; octet < 4; ++octet) {
+        record.ipKey |= static_cast<unsigned long long>(octets[octet] & 1023) << (16 + 10 * (3 - octet));
+    }
+    record.ipKey |= record.port & 0xFFFF;
+}
+
+/*
+ * Interpreta una línea "Mes día hh:mm:ss IP:puerto mensaje" con todas las claves que
+ * necesitan los análisis. Los campos y números se decodifican con common/log_tokenizer.h.
+ * Complejidad: O(k), donde k es la longitud de la línea.
+ * @return false si la línea está vacía o incompleta.
+ */
+inline bool parseRecord(const LargeString& buffer, size_t lineStart, size_t lineEnd, Record& record) {
+    LineTokens tokens;
+    if (!tokenizeLine(buffer.data() + lineStart, lineEnd - lineStart, tokens)) return false;
+
+    Span* fields[] = {&record.month, &record.day, &record.time, &record.ip};
+    for (int i = 0; i < 4; ++i) {
+        *fields[i] = {lineStart + tokens.start[i], tokens.end[i] - tokens.start[i]};
+    }
+    record.message = {lineStart + tokens.rest, lineEnd - lineStart - tokens.rest};
+
+    const char* line = buffer.data();
+    record.monthNumber = monthFromName(line + record.month.offset, record.month.length);
+    const char* day = line + record.day.offset;
+    record.dayNumber = readNumber(day, line + lineEnd);
+    computeRecordKeys(line, lineEnd, record);
+    return true;
+}
+
+/*
+ * Escribe un registro con el formato "MM-DD hh:mm:ss IP - mensaje" de act1.3 y act2.3.
+ * Complejidad: O(k), donde k es la longitud del registro.
+ */
+inline void writeSortedEntry(ostream& out, const LogStore& store, const Record& record) {
+    char date[8];
+    snprintf(date, sizeof(date), "%02d-%02d", record.monthNumber, record.dayNumber);
+    out << date << ' ' << store.view(record.time) << ' ' << store.view(record.ip)
+        << " - " << store.view(record.message) << '\n';
+}
+
+/*
+ * Agrega un registro con el mismo formato de writeSortedEntry al final de `out`
+ * (para armar bloques de salida sin flujos).
+ * Complejidad: O(k), donde k es la longitud del registro.
+ */
+inline void appendSortedEntry(string& out, const LogStore& store, const Record& record) {
+    char date[8];
+    snprintf(date, sizeof(date), "%02d-%02d ", record.monthNumber, record.dayNumber);
+    out.append(date);
+    out.append(store.view(record.time));
+    out += ' ';
+    out.append(store.view(record.ip));
+    out.append(" - ");
+    out.append(store.view(record.message));
+    out += '\n';
+}
+
+/*
+ * Carga e interpreta una bitácora completa (en paralelo, ver common/parallel_loader.h).
+ * Complejidad: O(n), donde n es el tamaño del archivo.
+ * @return false si el archivo no se pudo abrir.
+ */
+inline bool loadLogStore(const string& filename, LogStore& store) {
+    return loadParallel<Record>(filename, store.buffer, parseRecord, [&store](vector<Record>&& batch) {
+        reserveFromFirstBatch(store.records, batch, store.buffer.size());
+        store.records.insert(store.records.end(), batch.begin(), batch.end());
+    });
+}
+
+/*
+ * Interpreta una línea de un archivo ya ordenado ("MM-DD hh:mm:ss IP - mensaje", el formato
+ * de writeSortedEntry) con las mismas claves que parseRecord. Los segmentos de mes y día
+ * apuntan a los dígitos "MM" y "DD". Volver a escribir el registro da la misma línea.
+ * Complejidad: O(k), donde k es la longitud de la línea.
+ * @return false si la línea está vacía o no tiene ese formato.
+ */
+inline bool parseSortedRecord(const LargeString& buffer, size_t lineStart, size_t lineEnd, Record& record) {
+    const char* line = buffer.data();
+    Span* fields[] = {&record.month, &record.time, &record.ip};
+    size_t start = lineStart;
+    for (Span* field : fields) {
+        const char* space = static_cast<const char*>(memchr(line + start, ' ', lineEnd - start));
+        if (!space) return false;
+        *field = {start, static_cast<size_t>(space - line) - start};
+        start = space - line + 1;
+    }
+    // Separador " - " antes del mensaje (que puede estar vacío)
+    if (start >= lineEnd || line[start] != '-' || record.month.length != 5 || line[record.month.offset + 2] != '-') {
+        return false;
+    }
+    record.message = {min(start + 2, lineEnd), lineEnd - min(start + 2, lineEnd)};
+
+    record.day = {record.month.offset + 3, 2};
+    record.month.length = 2;
+    const char* month = line + record.month.offset;
+    const char* day = line + record.day.offset;
+    record.monthNumber = readNumber(month, line + lineEnd);
+    record.dayNumber = readNumber(day, line + lineEnd);
+    if (record.monthNumber > 12) return false;
+    computeRecordKeys(line, lineEnd, record);
+    return true;
+}
+
+/*
+ * Carga un archivo ya ordenado (por ejemplo sorted_logs.txt), conservando el orden del archivo.
+ * Complejidad: O(n), donde n es el tamaño del archivo.
+ * @return false si el archivo no se pudo abrir.
+ */
+inline bool loadSortedStore(const string& filename, LogStore& store) {
+    return loadParallel<Record>(filename, store.buffer, parseSortedRecord, [&store](vector<Record>&& batch) {
+        reserveFromFirstBatch(store.records, batch, store.buffer.size());
+        store.records.insert(store.records.end(), batch.begin(), batch.end());
+    });
+}
+
+/*
+ * Agrega al final de `store` el texto y los registros de `delta`. Los segmentos de los
+ * registros agregados se desplazan para apuntar a su nueva posición en el búfer.
+ * Complejidad: O(m), donde m es el tamaño de `delta`.
+ */
+inline void appendLogStore(LogStore& store, const LogStore& delta) {
+    size_t shift = store.buffer.size();
+    store.buffer += delta.buffer;
+    store.records.reserve(store.records.size() + delta.records.size());
+    for (Record record : delta.records) {
+        for (Span* span : {&record.month, &record.day, &record.time, &record.ip, &record.message}) {
+            span->offset += shift;
+        }
+        store.records.push_back(record);
+    }
+}
+
+#endif
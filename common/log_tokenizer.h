@@ -0,0 +1,263 @@
+// Header para dividir y decodificar líneas de bitácora con instrucciones vectoriales
+//
+// Los separadores de campo se buscan en bloques de 32 bytes con AVX2 o SSE2 (la variante
+// se elige en tiempo de ejecución según el procesador) y hay una versión escalar para
+// otras arquitecturas. Los números (hora, octetos y puerto) se decodifican con SWAR:
+// varios dígitos a la vez dentro de un entero de 64 bits.
+#ifndef LOG_TOKENIZER_H
+#define LOG_TOKENIZER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define LOG_TOKENIZER_X86 1
+#include <immintrin.h>
+#endif
+
+using namespace std;
+
+// Campos al inicio de una línea ("Mes día hh:mm:ss IP:puerto"), relativos al inicio de la línea.
+struct LineTokens {
+    size_t start[4];
+    size_t end[4];
+    int count;    // Cantidad de campos encontrados (máximo 4)
+    size_t rest;  // Posición justo después del cuarto campo (inicio del mensaje)
+};
+
+/*
+ * Empaca los tres caracteres del nombre abreviado de un mes en un entero.
+ * Complejidad: O(1).
+ */
+constexpr uint32_t packMonth(const char* name) {
+    return static_cast<uint32_t>(static_cast<unsigned char>(name[0])) << 16 |
+           static_cast<uint32_t>(static_cast<unsigned char>(name[1])) << 8 |
+           static_cast<uint32_t>(static_cast<unsigned char>(name[2]));
+}
+
+// Nombres de los meses empacados, calculados en compilación
+constexpr uint32_t MONTH_CODES[12] = {
+    packMonth("Jan"), packMonth("Feb"), packMonth("Mar"), packMonth("Apr"), packMonth("May"), packMonth("Jun"),
+    packMonth("Jul"), packMonth("Aug"), packMonth("Sep"), packMonth("Oct"), packMonth("Nov"), packMonth("Dec")};
+
+// Número de cada mes con dos dígitos (índice 0 para meses inválidos)
+constexpr const char* MONTH_NUMBERS[13] = {"00", "01", "02", "03", "04", "05", "06",
+                                           "07", "08", "09", "10", "11", "12"};
+
+/*
+ * Convierte el nombre abreviado de un mes ("Jan" ... "Dec") a su número.
+ * Complejidad: O(1).
+ * @return Número del mes (1-12), o 0 si no es válido.
+ */
+constexpr int monthFromName(const char* name, size_t length) {
+    if (length != 3) return 0;
+    uint32_t code = packMonth(name);
+    for (int i = 0; i < 12; ++i) {
+        if (MONTH_CODES[i] == code) return i + 1;
+    }
+    return 0;
+}
+
+static_assert(monthFromName("Jan", 3) == 1 && monthFromName("Oct", 3) == 10 && monthFromName("Foo", 3) == 0,
+              "Tabla de meses inválida");
+
+/*
+ * Máscara de separadores (espacio o tabulador) en 32 bytes, versión escalar.
+ * Complejidad: O(1).
+ * @return Bit i encendido si p[i] es separador.
+ */
+inline uint32_t separatorMaskScalar(const char* p) {
+    uint32_t mask = 0;
+    for (int i = 0; i < 32; ++i) {
+        mask |= static_cast<uint32_t>(p[i] == ' ' || p[i] == '\t') << i;
+    }
+    return mask;
+}
+
+#ifdef LOG_TOKENIZER_X86
+// Máscara de separadores en 32 bytes con dos comparaciones SSE2 de 16 bytes.
+inline uint32_t separatorMaskSSE2(const char* p) {
+    const __m128i space = _mm_set1_epi8(' ');
+    const __m128i tab = _mm_set1_epi8('\t');
+    __m128i low = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    __m128i high = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 16));
+    uint32_t lowMask = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(low, space), _mm_cmpeq_epi8(low, tab)));
+    uint32_t highMask = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(high, space), _mm_cmpeq_epi8(high, tab)));
+    return lowMask | (highMask << 16);
+}
+
+// Máscara de separadores en 32 bytes con una sola comparación AVX2.
+__attribute__((target("avx2"))) inline uint32_t separatorMaskAVX2(const char* p) {
+    __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    __m256i separators = _mm256_or_si256(_mm256_cmpeq_epi8(block, _mm256_set1_epi8(' ')),
+                                         _mm256_cmpeq_epi8(block, _mm256_set1_epi8('\t')));
+    return static_cast<uint32_t>(_mm256_movemask_epi8(separators));
+}
+#endif
+
+typedef uint32_t (*SeparatorMaskFunction)(const char*);
+
+/*
+ * Elige la implementación más rápida que soporta el procesador.
+ * Complejidad: O(1).
+ */
+inline SeparatorMaskFunction selectSeparatorMask() {
+#ifdef LOG_TOKENIZER_X86
+    if (__builtin_cpu_supports("avx2")) return separatorMaskAVX2;
+    return separatorMaskSSE2;
+#else
+    return separatorMaskScalar;
+#endif
+}
+
+/*
+ * Máscara de separadores en 32 bytes con la implementación elegida al arrancar.
+ * Complejidad: O(1).
+ */
+inline uint32_t separatorMask32(const char* p) {
+    static const SeparatorMaskFunction function = selectSeparatorMask();
+    return function(p);
+}
+
+/*
+ * Encuentra los primeros cuatro campos de una línea procesando 32 bytes por iteración.
+ * Es equivalente a leer cuatro campos con `>>`: el mensaje es el resto de la línea a
+ * partir de `rest`, incluyendo el espacio que lo separa de la IP.
+ * Nunca lee más allá de `length` (el último bloque incompleto se revisa byte por byte).
+ * Complejidad: O(k), donde k es la posición del final del cuarto campo.
+ * @param line Inicio de la línea.
+ * @param length Longitud de la línea sin el salto de línea.
+ * @param tokens Posiciones de los campos encontrados.
+ * @return true si la línea tiene al menos cuatro campos.
+ */
+inline bool tokenizeLine(const char* line, size_t length, LineTokens& tokens) {
+    tokens.count = 0;
+    bool inField = false;
+    size_t pos = 0;
+
+    while (pos < length) {
+        size_t blockLength = length - pos < 32 ? length - pos : 32;
+        uint64_t valid = (1ULL << blockLength) - 1;
+        uint64_t separators;
+        if (blockLength == 32) {
+            separators = separatorMask32(line + pos);
+        } else {
+            separators = 0;
+            for (size_t i = 0; i < blockLength; ++i) {
+                separators |= static_cast<uint64_t>(line[pos + i] == ' ' || line[pos + i] == '\t') << i;
+            }
+        }
+
+        // Inicios: carácter de campo precedido de separador; fines: separador precedido de campo
+        uint64_t field = ~separators & valid;
+        uint64_t previous = (field << 1) | (inField ? 1 : 0);
+        uint64_t starts = field & ~previous;
+        uint64_t ends = ~field & valid & previous;
+
+        for (uint64_t events = starts | ends; events; events &= events - 1) {
+            int i = __builtin_ctzll(events);
+            if ((starts >> i) & 1) {
+                tokens.start[tokens.count] = pos + i;
+            } else {
+                tokens.end[tokens.count++] = pos + i;
+                if (tokens.count == 4) {
+                    tokens.rest = pos + i;
+                    return true;
+                }
+            }
+        }
+
+        inField = (field >> (blockLength - 1)) & 1;
+        pos += blockLength;
+    }
+
+    if (inField) tokens.end[tokens.count++] = length;
+    tokens.rest = length;
+    return tokens.count == 4;
+}
+
+/*
+ * Decodifica hasta 8 dígitos con SWAR (tres multiplicaciones en lugar de un ciclo).
+ * Requiere que haya 8 bytes legibles a partir de p.
+ * Complejidad: O(1).
+ * @param p Primer dígito.
+ * @param digits Cantidad de dígitos (1-8).
+ */
+inline uint32_t parseDigitsSWAR(const char* p, int digits) {
+    uint64_t value;
+    memcpy(&value, p, 8);
+    value <<= 8 * (8 - digits); // Los bytes sobrantes salen y quedan ceros a la izquierda
+    value = ((value & 0x0F0F0F0F0F0F0F0FULL) * 2561) >> 8;
+    value = ((value & 0x00FF00FF00FF00FFULL) * 6553601) >> 16;
+    return static_cast<uint32_t>(((value & 0x0000FFFF0000FFFFULL) * 42949672960001ULL) >> 32);
+}
+
+/*
+ * Lee un número decimal y avanza hasta el primer carácter que no es dígito.
+ * Usa SWAR cuando hay 8 bytes legibles y la versión escalar cerca del final.
+ * Complejidad: O(1) para números de hasta 8 dígitos.
+ * @param p Posición actual; se avanza después del número.
+ * @param end Límite de lectura.
+ */
+inline uint32_t readNumber(const char*& p, const char* end) {
+    const char* start = p;
+    while (p < end && p - start < 8 && static_cast<unsigned>(*p - '0') < 10) ++p;
+    int digits = p - start;
+    if (digits == 0) return 0;
+    if (end - start >= 8) return parseDigitsSWAR(start, digits);
+
+    uint32_t value = 0;
+    for (const char* c = start; c < p; ++c) value = value * 10 + (*c - '0');
+    return value;
+}
+
+/*
+ * Decodifica una hora "hh:mm:ss". Con exactamente 8 caracteres usa SWAR: al restar '0'
+ * cada byte queda entre 0 y 10, así que v * 10 + (v >> 8) forma los tres pares de dígitos
+ * sin acarreos entre bytes.
+ * Complejidad: O(1).
+ * @return false si el texto no tiene el formato esperado.
+ */
+inline bool parseClock(const char* p, size_t length, int& hour, int& minute, int& second) {
+    if (length == 8 && p[2] == ':' && p[5] == ':') {
+        uint64_t value;
+        memcpy(&value, p, 8);
+        value -= 0x3030303030303030ULL;
+        value = value * 10 + (value >> 8);
+        hour = value & 0xFF;
+        minute = (value >> 24) & 0xFF;
+        second = (value >> 48) & 0xFF;
+        return true;
+    }
+
+    const char* end = p + length;
+    int* parts[] = {&hour, &minute, &second};
+    for (int* part : parts) {
+        *part = readNumber(p, end);
+        if (p < end && *p == ':') ++p;
+    }
+    return p == end;
+}
+
+/*
+ * Decodifica "a.b.c.d:puerto" en sus cuatro octetos y el puerto (0 si no lo tiene).
+ * Complejidad: O(1).
+ * @param p Inicio de la IP.
+ * @param end Límite de lectura (puede ir más allá del campo, por ejemplo el fin de la línea).
+ * @return Posición después del último carácter decodificado.
+ */
+inline const char* parseIPPort(const char* p, const char* end, int octets[4], int& port) {
+    for (int i = 0; i < 4; ++i) {
+        octets[i] = readNumber(p, end);
+        if (i < 3 && p < end && *p == '.') ++p;
+    }
+    port = 0;
+    if (p < end && *p == ':') {
+        ++p;
+        port = readNumber(p, end);
+    }
+    return p;
+}
+
+#endif
@@ -0,0 +1,522 @@
+// Header para la carga en paralelo de archivos de bitácora
+#ifndef PARALLEL_LOADER_H
+#define PARALLEL_LOADER_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <cstddef>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "compressed_input.h"
+#include "large_pages.h"
+
+using namespace std;
+
+// Reintentos con cesión del procesador antes de que push/pop se duerman
+const int QUEUE_SPIN_LIMIT = 64;
+
+/*
+ * Cola acotada sin candados para varios productores y varios consumidores.
+ * Cada celda guarda un número de secuencia que indica si está libre u ocupada
+ * para la vuelta actual del arreglo circular (algoritmo de D. Vyukov).
+ * push y pop reintentan unas cuantas veces y después se duermen en una variable de
+ * condición, así que los hilos que esperan (por ejemplo, los intérpretes mientras el
+ * lector espera al disco) no consumen procesador. El candado solo se toma si hay
+ * hilos dormidos.
+ */
+template <typename T>
+class BoundedQueue {
+private:
+    struct Cell {
+        atomic<size_t> sequence;
+        T value;
+    };
+
+    unique_ptr<Cell[]> cells;
+    size_t mask;
+    alignas(64) atomic<size_t> enqueuePos;
+    alignas(64) atomic<size_t> dequeuePos;
+    alignas(64) atomic<int> sleepers; // Hilos dormidos en push o pop
+    mutex sleepLock;
+    condition_variable changed;
+
+    // Despierta a los hilos dormidos después de agregar o extraer un elemento.
+    // La lectura es una operación atómica de lectura y escritura (fetch_add(0)) para que
+    // quede ordenada con el registro de un hilo que se va a dormir (ver waitFor).
+    void wakeSleepers() {
+        if (sleepers.fetch_add(0, memory_order_acq_rel) > 0) {
+            lock_guard<mutex> guard(sleepLock);
+            changed.notify_all();
+        }
+    }
+
+    // Indica si vale la pena reintentar: hay una celda libre (push) u ocupada (pop)
+    bool mayPush() const {
+        size_t pos = enqueuePos.load(memory_order_relaxed);
+        return (intptr_t)cells[pos & mask].sequence.load(memory_order_acquire) - (intptr_t)pos >= 0;
+    }
+    bool mayPop() const {
+        size_t pos = dequeuePos.load(memory_order_relaxed);
+        return (intptr_t)cells[pos & mask].sequence.load(memory_order_acquire) - (intptr_t)(pos + 1) >= 0;
+    }
+
+    // Reintenta `attempt` hasta que tenga éxito: primero cediendo el procesador y después
+    // durmiendo hasta que otro hilo cambie la cola (`ready` indica si ya cambió)
+    template <typename Attempt, typename Ready>
+    void waitFor(Attempt attempt, Ready ready) {
+        for (int spin = 0; !attempt(); ++spin) {
+            if (spin < QUEUE_SPIN_LIMIT) {
+                this_thread::yield();
+                continue;
+            }
+            unique_lock<mutex> guard(sleepLock);
+            // O quien cambió la cola ve que hay alguien dormido, o este hilo ve el cambio
+            sleepers.fetch_add(1, memory_order_acq_rel);
+            if (!ready()) changed.wait(guard);
+            sleepers.fetch_sub(1, memory_order_relaxed);
+        }
+    }
+
+public:
+    /*
+     * Constructor de la cola.
+     * @param capacity Capacidad mínima; se redondea a la siguiente potencia de 2.
+     */
+    explicit BoundedQueue(size_t capacity) : enqueuePos(0), dequeuePos(0), sleepers(0) {
+        size_t size = 2;
+        while (size < capacity) size <<= 1;
+        cells.reset(new Cell[size]);
+        mask = size - 1;
+        for (size_t i = 0; i < size; ++i) cells[i].sequence.store(i, memory_order_relaxed);
+    }
+
+    /*
+     * Intenta agregar un elemento sin bloquear.
+     * Complejidad: O(1).
+     * @return false si la cola está llena (el valor no se modifica).
+     */
+    bool tryPush(T& value) {
+        size_t pos = enqueuePos.load(memory_order_relaxed);
+        while (true) {
+            Cell& cell = cells[pos & mask];
+            size_t sequence = cell.sequence.load(memory_order_acquire);
+            intptr_t diff = (intptr_t)sequence - (intptr_t)pos;
+            if (diff == 0) {
+                if (enqueuePos.compare_exchange_weak(pos, pos + 1, memory_order_relaxed)) {
+                    cell.value = move(value);
+                    cell.sequence.store(pos + 1, memory_order_release);
+                    wakeSleepers();
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = enqueuePos.load(memory_order_relaxed);
+            }
+        }
+    }
+
+    /*
+     * Intenta extraer un elemento sin bloquear.
+     * Complejidad: O(1).
+     * @return false si la cola está vacía.
+     */
+    bool tryPop(T& value) {
+        size_t pos = dequeuePos.load(memory_order_relaxed);
+        while (true) {
+            Cell& cell = cells[pos & mask];
+            size_t sequence = cell.sequence.load(memory_order_acquire);
+            intptr_t diff = (intptr_t)sequence - (intptr_t)(pos + 1);
+            if (diff == 0) {
+                if (dequeuePos.compare_exchange_weak(pos, pos + 1, memory_order_relaxed)) {
+                    value = move(cell.value);
+                    cell.sequence.store(pos + mask + 1, memory_order_release);
+                    wakeSleepers();
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = dequeuePos.load(memory_order_relaxed);
+            }
+        }
+    }
+
+    // Agrega un elemento; si la cola está llena espera a que haya lugar.
+    void push(T value) {
+        waitFor([&]() { return tryPush(value); }, [this]() { return mayPush(); });
+    }
+
+    // Extrae un elemento; si la cola está vacía espera a que llegue uno.
+    void pop(T& value) {
+        waitFor([&]() { return tryPop(value); }, [this]() { return mayPop(); });
+    }
+};
+
+// Segmento [begin, end) del búfer que contiene solo líneas completas.
+struct Chunk {
+    size_t sequence;
+    size_t begin;
+    size_t end;
+};
+
+// Registros interpretados de un segmento, con la secuencia del segmento de origen.
+template <typename Record>
+struct Batch {
+    size_t sequence;
+    vector<Record> records;
+};
+
+// Secuencia que indica a los hilos que ya no hay más trabajo.
+const size_t END_OF_INPUT = static_cast<size_t>(-1);
+
+// Vectores de lotes por hilo intérprete que circulan en el pipeline (ver runPipeline)
+const unsigned BATCH_POOL_PER_THREAD = 4;
+
+/*
+ * Ejecuta el pipeline de tres etapas sobre un búfer que se llena progresivamente:
+ *  - el hilo productor escribe en el búfer (lectura del disco o descompresión) y llama
+ *    `publish(fin, ultimo)` cada vez que el prefijo [0, fin) está completo; el pipeline
+ *    lo divide en segmentos de hasta `chunkSize` bytes que terminan en un salto de línea
+ *    (antes del final solo cuando ya hay `chunkSize` bytes, para no crear segmentos
+ *    pequeños que cambien la densidad con la que se reservan los lotes);
+ *  - `threads` hilos intérpretes convierten cada línea de un segmento en un registro;
+ *  - el hilo que llama recibe los lotes en el orden original y los entrega al consumidor.
+ * Las etapas se comunican con colas acotadas, por lo que la producción se traslapa con
+ * la interpretación. El búfer debe tener su tamaño final antes de empezar y no cambiar
+ * de tamaño mientras los hilos trabajan, así que los registros pueden guardar posiciones
+ * dentro de él. Los lotes usan un grupo fijo de vectores (BATCH_POOL_PER_THREAD por hilo)
+ * que se reciclan entre segmentos y se reservan una vez según las líneas del primer
+ * segmento, así que la cantidad de reservas de memoria no crece con la cantidad de líneas.
+ * Si el productor termina sin publicar con `ultimo` = true, la línea incompleta del final
+ * queda sin interpretar y el valor de regreso indica dónde empieza, para continuar con otra
+ * llamada después de hacer crecer el búfer.
+ * Complejidad: O(n), donde n es el tamaño del búfer, repartido entre los hilos.
+ * @param buffer Búfer que llenará el productor.
+ * @param produce Función void(publish) que se ejecuta en el hilo productor.
+ * @param parseLine Función bool(const LargeString& buffer, size_t inicio, size_t fin, Record&)
+ *        que interpreta la línea [inicio, fin) y regresa false si debe descartarse.
+ * @param consume Función void(vector<Record>&&) que recibe cada lote en orden. Si solo
+ *        mueve los registros (sin quedarse con el vector), el vector se reutiliza.
+ * @param threads Cantidad de hilos intérpretes.
+ * @param chunkSize Tamaño máximo de cada segmento en bytes.
+ * @param begin Posición del búfer donde empieza la interpretación (lo anterior ya se interpretó).
+ * @return Fin de la última línea entregada a los intérpretes.
+ */
+template <typename Record, typename Producer, typename Parser, typename Consumer>
+size_t runPipeline(const LargeString& buffer, Producer produce, Parser parseLine, Consumer consume,
+                   unsigned threads, size_t chunkSize, size_t begin = 0) {
+    BoundedQueue<Chunk> chunks(2 * threads);
+    BoundedQueue<Batch<Record>> batches(4 * threads);
+    // Grupo fijo de vectores para los lotes: cada intérprete toma uno antes de tomar un
+    // segmento (así el segmento más antiguo en curso siempre tiene vector y el pipeline no
+    // se atasca) y el consumidor lo regresa vacío después de entregar el lote
+    const size_t poolSize = BATCH_POOL_PER_THREAD * threads;
+    BoundedQueue<vector<Record>> spare(poolSize);
+    for (size_t i = 0; i < poolSize; ++i) spare.push({});
+
+    // Etapa 1: producción del búfer y división en segmentos de líneas completas
+    size_t lineStart = begin;
+    size_t linesPerChunk = 0; // Líneas de un segmento de chunkSize bytes según el primero
+    thread producer([&]() {
+        size_t sequence = 0;
+        auto publish = [&](size_t readyEnd, bool last) {
+            while (lineStart < readyEnd) {
+                // Solo segmentos completos hasta el final, para que todos tengan tamaño parecido
+                if (!last && readyEnd - lineStart < chunkSize) break;
+                size_t limit = min(readyEnd, lineStart + chunkSize);
+                size_t end = readyEnd;
+                if (limit < readyEnd || !last) {
+                    size_t newline = buffer.rfind('\n', limit - 1);
+                    if (newline == string::npos || newline < lineStart) {
+                        // Línea más larga que un segmento: extenderlo hasta el siguiente salto
+                        const char* next = static_cast<const char*>(
+                            memchr(buffer.data() + limit, '\n', readyEnd - limit));
+                        if (!next) {
+                            if (!last) break; // Esperar a que se complete la línea
+                            next = buffer.data() + readyEnd - 1;
+                        }
+                        newline = next - buffer.data();
+                    }
+                    end = newline + 1;
+                }
+                if (sequence == 0) {
+                    size_t lines = count(buffer.begin() + lineStart, buffer.begin() + end, '\n') + 1;
+                    linesPerChunk = lines * chunkSize / max(end - lineStart, chunkSize) + 1;
+                }
+                chunks.push({sequence++, lineStart, end});
+                lineStart = end;
+            }
+        };
+        produce(publish);
+        for (unsigned i = 0; i < threads; ++i) chunks.push({END_OF_INPUT, 0, 0});
+    });
+
+    // Etapa 2: interpretación de líneas
+    vector<thread> parsers;
+    for (unsigned i = 0; i < threads; ++i) {
+        parsers.emplace_back([&]() {
+            Chunk chunk;
+            while (true) {
+                Batch<Record> batch;
+                spare.pop(batch.records);
+                chunks.pop(chunk);
+                if (chunk.sequence == END_OF_INPUT) {
+                    spare.push(move(batch.records));
+                    break;
+                }
+
+                // Cada vector del grupo se reserva una sola vez (con 1/8 de margen) para un
+                // segmento completo con la densidad del primero; ninguno crece por duplicación
+                // mientras los segmentos tengan una densidad parecida
+                batch.sequence = chunk.sequence;
+                size_t chunkBytes = chunk.end - chunk.begin;
+                size_t expected = linesPerChunk * max(chunkBytes, chunkSize) / chunkSize;
+                if (batch.records.capacity() < expected) batch.records.reserve(expected + expected / 8);
+                size_t lineStart = chunk.begin;
+                while (lineStart < chunk.end) {
+                    const char* newline = static_cast<const char*>(
+                        memchr(buffer.data() + lineStart, '\n', chunk.end - lineStart));
+                    size_t lineEnd = newline ? newline - buffer.data() : chunk.end;
+                    Record record;
+                    if (lineEnd > lineStart && parseLine(buffer, lineStart, lineEnd, record)) {
+                        batch.records.push_back(move(record));
+                    }
+                    lineStart = lineEnd + 1;
+                }
+                batches.push(move(batch));
+            }
+            batches.push({END_OF_INPUT, {}});
+        });
+    }
+
+    // Etapa 3: entrega de los lotes al consumidor en el orden del archivo. Los lotes que
+    // llegan antes de su turno esperan en `pending` (a lo más uno por vector del grupo).
+    vector<Batch<Record>> pending;
+    pending.reserve(poolSize);
+    size_t nextSequence = 0;
+    unsigned finished = 0;
+    Batch<Record> batch;
+    while (finished < threads) {
+        batches.pop(batch);
+        if (batch.sequence == END_OF_INPUT) {
+            ++finished;
+            continue;
+        }
+        pending.push_back(move(batch));
+        for (size_t i = 0; i < pending.size();) {
+            if (pending[i].sequence != nextSequence) {
+                ++i;
+                continue;
+            }
+            // El vector regresa al grupo (si el consumidor se quedó con él, regresa uno vacío)
+            vector<Record>& records = pending[i].records;
+            consume(move(records));
+            records.clear();
+            spare.push(move(records));
+            if (i + 1 < pending.size()) pending[i] = move(pending.back());
+            pending.pop_back();
+            ++nextSequence;
+            i = 0;
+        }
+    }
+
+    producer.join();
+    for (thread& parser : parsers) parser.join();
+    return lineStart;
+}
+
+/*
+ * Estima la cantidad de registros de una carga a partir de su primer lote: la densidad
+ * del lote (registros por byte desde el inicio del búfer hasta el mensaje de su último
+ * registro) por el tamaño del búfer, con 1/8 de margen. Sirve para cualquier registro
+ * cuyo último campo sea el segmento `message`.
+ * Complejidad: O(1).
+ * @param batch Primer lote entregado por loadParallel (0 si está vacío).
+ * @param bufferSize Tamaño del búfer de la carga.
+ */
+template <typename Record>
+size_t estimateRecordCount(const vector<Record>& batch, size_t bufferSize) {
+    if (batch.empty()) return 0;
+    const Record& last = batch.back();
+    double recordsPerByte = static_cast<double>(batch.size()) / (last.message.offset + last.message.length + 1);
+    return max(batch.size(), static_cast<size_t>(recordsPerByte * bufferSize * 1.125) + 1);
+}
+
+/*
+ * Reserva de una vez el arreglo de registros de una carga con estimateRecordCount, así
+ * que el arreglo no crece por duplicación y la cantidad de reservas no depende del
+ * tamaño del archivo.
+ * Complejidad: O(1) más la reserva.
+ * @param records Arreglo de la carga (sin efecto si ya tiene registros).
+ * @param batch Primer lote entregado por loadParallel.
+ * @param bufferSize Tamaño del búfer de la carga.
+ */
+template <typename Records, typename Record>
+void reserveFromFirstBatch(Records& records, const vector<Record>& batch, size_t bufferSize) {
+    if (records.empty()) records.reserve(estimateRecordCount(batch, bufferSize));
+}
+
+/*
+ * Interpreta en paralelo un búfer que ya está completo en memoria.
+ * Complejidad: O(n), donde n es el tamaño del búfer, repartido entre los hilos.
+ * @param buffer Contenido a interpretar.
+ * @param parseLine Igual que en runPipeline.
+ * @param consume Igual que en runPipeline.
+ * @param threads Cantidad de hilos intérpretes (0 = uno por núcleo).
+ * @param chunkSize Tamaño máximo de cada segmento en bytes.
+ */
+template <typename Record, typename Parser, typename Consumer>
+void parseParallel(const LargeString& buffer, Parser parseLine, Consumer consume,
+                   unsigned threads = 0, size_t chunkSize = 4 << 20) {
+    if (threads == 0) threads = max(1u, thread::hardware_concurrency());
+    runPipeline<Record>(buffer, [&](auto publish) { publish(buffer.size(), true); },
+                        parseLine, consume, threads, chunkSize);
+}
+
+/*
+ * Carga un archivo de bitácora en paralelo (ver runPipeline).
+ * Si el archivo está comprimido (gzip, bgzip o zstd) se descomprime en memoria sin
+ * pasar por el disco: los formatos divididos en bloques independientes (bgzip y tramas
+ * zstd con tamaño declarado) se descomprimen en paralelo y cada bloque se interpreta en
+ * cuanto está listo; los demás (gzip común, zstd sin tamaños) se descomprimen como un solo
+ * flujo por tramos, y cada tramo se interpreta mientras se descomprime el siguiente.
+ * El gzip común se lee del disco por tramos; para los otros formatos se necesita el archivo
+ * completo en memoria para obtener la tabla de bloques.
+ * Complejidad: O(n), donde n es el tamaño del archivo, repartido entre los hilos.
+ * @param filename Nombre del archivo a cargar.
+ * @param buffer Búfer donde se almacenará el contenido (descomprimido) del archivo.
+ * @param parseLine Función bool(const LargeString& buffer, size_t inicio, size_t fin, Record&)
+ *        que interpreta la línea [inicio, fin) y regresa false si debe descartarse.
+ * @param consume Función void(vector<Record>&&) que recibe cada lote en orden.
+ * @param threads Cantidad de hilos intérpretes y de descompresión (0 = uno por núcleo).
+ * @param chunkSize Tamaño de cada lectura y de cada segmento en bytes.
+ * @return false si el archivo no se pudo abrir o descomprimir.
+ */
+template <typename Record, typename Parser, typename Consumer>
+bool loadParallel(const string& filename, LargeString& buffer, Parser parseLine, Consumer consume,
+                  unsigned threads = 0, size_t chunkSize = 4 << 20) {
+    ifstream file(filename, ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    file.seekg(0, ios::end);
+    size_t size = static_cast<size_t>(file.tellg());
+    file.seekg(0, ios::beg);
+    if (threads == 0) threads = max(1u, thread::hardware_concurrency());
+
+    // Detectar si el archivo está comprimido
+    string header(min<size_t>(size, 18), '\0');
+    file.read(&header[0], header.size());
+    file.seekg(0, ios::beg);
+    InputFormat format = detectFormat(header);
+
+    if (format == InputFormat::Plain) {
+        // Lecturas secuenciales grandes directamente sobre el búfer
+        buffer.resize(size);
+        size_t bytesRead = 0;
+        runPipeline<Record>(buffer, [&](auto publish) {
+            while (bytesRead < size) {
+                file.read(&buffer[bytesRead], min(chunkSize, size - bytesRead));
+                size_t count = static_cast<size_t>(file.gcount());
+                if (count == 0) break;
+                bytesRead += count;
+                publish(bytesRead, false);
+            }
+            publish(bytesRead, true);
+        }, parseLine, consume, threads, chunkSize);
+        buffer.resize(bytesRead);
+        return true;
+    }
+
+    if (!formatSupported(format)) {
+        cerr << "Formato comprimido no soportado en esta compilación: " << filename << endl;
+        return false;
+    }
+
+    string input;
+    if (format != InputFormat::Gzip) {
+        input.resize(size);
+        file.read(&input[0], size);
+        input.resize(static_cast<size_t>(file.gcount()));
+
+        vector<CompressedBlock> blocks;
+        size_t totalSize;
+        if (findBlocks(format, input, blocks, totalSize)) {
+            buffer.resize(totalSize);
+            bool ok = true;
+            size_t readyEnd = 0;
+            runPipeline<Record>(buffer, [&](auto publish) {
+                ok = decompressParallel(format, input, blocks, &buffer[0], threads, [&](size_t end) {
+                    readyEnd = end;
+                    publish(end, false);
+                });
+                publish(readyEnd, true);
+            }, parseLine, consume, threads, chunkSize);
+            buffer.resize(readyEnd);
+            if (!ok) cerr << "Error al descomprimir el archivo: " << filename << endl;
+            return ok;
+        }
+    }
+
+    // Flujo único: cada tramo se descomprime directamente en el búfer y se publica. El búfer
+    // no puede crecer mientras el pipeline trabaja, así que si la estimación se queda corta
+    // el pipeline termina en la última línea completa, el búfer duplica su tamaño y otro
+    // pipeline continúa desde ahí.
+    StreamDecompressor stream(format);
+    string trailer(min<size_t>(size, 4), '\0');
+    if (input.empty()) {
+        file.seekg(size - trailer.size(), ios::beg);
+        file.read(&trailer[0], trailer.size());
+        file.seekg(0, ios::beg);
+    } else {
+        trailer = input.substr(input.size() - trailer.size());
+        stream.feed(input.data(), input.size(), true);
+        string().swap(input);
+    }
+    buffer.resize(estimateStreamSize(format, size, trailer));
+
+    string compressed(chunkSize, '\0');
+    StreamStatus status = StreamStatus::NeedOutput;
+    size_t written = 0, parsedEnd = 0;
+    while (status == StreamStatus::NeedOutput) {
+        if (written == buffer.size()) buffer.resize(2 * buffer.size());
+        parsedEnd = runPipeline<Record>(buffer, [&](auto publish) {
+            while (true) {
+                size_t produced = 0;
+                status = stream.run(&buffer[written], min(chunkSize, buffer.size() - written), produced);
+                written += produced;
+                if (produced > 0) publish(written, false);
+                if (status == StreamStatus::NeedInput) {
+                    file.read(&compressed[0], compressed.size());
+                    size_t count = static_cast<size_t>(file.gcount());
+                    stream.feed(compressed.data(), count, count < compressed.size());
+                } else if (status != StreamStatus::NeedOutput || written == buffer.size()) {
+                    break;
+                }
+            }
+            // Si se llenó el búfer, la línea incompleta espera al siguiente pipeline
+            if (status != StreamStatus::NeedOutput) publish(written, true);
+        }, parseLine, consume, threads, chunkSize, parsedEnd);
+    }
+    buffer.resize(written);
+    if (buffer.capacity() > written + written / 4) buffer.shrink_to_fit();
+    if (status != StreamStatus::Done) {
+        cerr << "Error al descomprimir el archivo: " << filename << endl;
+        return false;
+    }
+    return true;
+}
+
+#endif
@@ -0,0 +1,252 @@
+// Header con contadores de eventos en ventanas deslizantes de tiempo
+//
+// Cada ventana es un anillo de WINDOW_BUCKETS cubetas: al avanzar el tiempo solo se
+// vacían las cubetas que salen de la ventana, así que registrar un evento cuesta O(1)
+// y la memoria por clave es fija. Las claves (IPs o puertos) viven en una tabla de
+// capacidad fija que recicla las entradas inactivas, de modo que la memoria total no
+// crece con el tamaño de la bitácora.
+#ifndef SLIDING_WINDOW_H
+#define SLIDING_WINDOW_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+using namespace std;
+
+// Cubetas por ventana (la ventana mide WINDOW_BUCKETS * segundos por cubeta)
+const int WINDOW_BUCKETS = 60;
+
+// Cantidad de ventanas por clave: 1 min, 10 min y 1 h
+const int WINDOW_COUNT = 3;
+
+// Segundos por cubeta de cada ventana
+const int BUCKET_SECONDS[WINDOW_COUNT] = {1, 10, 60};
+
+// Nombre de cada ventana para los reportes
+const char* const WINDOW_NAMES[WINDOW_COUNT] = {"1 min", "10 min", "1 h"};
+
+// Duración de la ventana más larga; una clave sin eventos en este tiempo se puede reciclar
+const int LONGEST_WINDOW_SECONDS = WINDOW_BUCKETS * BUCKET_SECONDS[WINDOW_COUNT - 1];
+
+// Posiciones revisadas al buscar una clave en la tabla
+const int PROBE_LIMIT = 8;
+
+// Contador de eventos en una ventana deslizante de WINDOW_BUCKETS cubetas.
+struct WindowCounter {
+    uint32_t buckets[WINDOW_BUCKETS];
+    uint32_t total;
+    long long head; // Cubeta absoluta más reciente (tiempo / segundos por cubeta)
+
+    /*
+     * Vacía la ventana.
+     * Complejidad: O(B), donde B es la cantidad de cubetas.
+     */
+    void reset() {
+        for (uint32_t& bucket : buckets) bucket = 0;
+        total = 0;
+        head = -1;
+    }
+
+    /*
+     * Avanza la ventana hasta la cubeta `bucket`, vaciando las que salen de ella.
+     * Complejidad: O(1) (a lo más B cubetas).
+     */
+    void advance(long long bucket) {
+        if (bucket <= head) return;
+        long long steps = bucket - head < WINDOW_BUCKETS ? bucket - head : WINDOW_BUCKETS;
+        for (long long i = 1; i <= steps; ++i) {
+            uint32_t& expired = buckets[(head + i) % WINDOW_BUCKETS];
+            total -= expired;
+            expired = 0;
+        }
+        head = bucket;
+    }
+
+    /*
+     * Registra un evento en la cubeta `bucket`.
+     * Complejidad: O(1).
+     * @return false si el evento es más antiguo que la ventana (se descarta).
+     */
+    bool add(long long bucket) {
+        advance(bucket);
+        if (bucket <= head - WINDOW_BUCKETS) return false;
+        buckets[bucket % WINDOW_BUCKETS]++;
+        total++;
+        return true;
+    }
+};
+
+// Contadores de una clave en todas las ventanas.
+struct KeyWindows {
+    unsigned long long key;
+    bool used;
+    int lastSeen;  // Tiempo del evento más reciente
+    int lastAlert; // Tiempo de la última alerta (para no repetirla en cada evento)
+    WindowCounter windows[WINDOW_COUNT];
+};
+
+/*
+ * Tabla de capacidad fija con los contadores de cada clave (direccionamiento abierto).
+ * Si las posiciones revisadas están ocupadas por claves activas se reemplaza la menos
+ * reciente, así que la memoria es O(capacidad) sin importar cuántas claves aparezcan.
+ */
+class WindowTable {
+private:
+    vector<KeyWindows> slots;
+    size_t mask;
+    size_t evictions;
+
+public:
+    /*
+     * Complejidad: O(c), donde c es la capacidad.
+     * @param capacity Cantidad de claves (se redondea a la siguiente potencia de 2).
+     */
+    explicit WindowTable(size_t capacity) : mask(0), evictions(0) {
+        size_t size = 1;
+        while (size < capacity) size *= 2;
+        slots.resize(size);
+        for (KeyWindows& slot : slots) slot.used = false;
+        mask = size - 1;
+    }
+
+    /*
+     * Busca los contadores de una clave y, si no existen, los crea.
+     * Complejidad: O(1) (a lo más PROBE_LIMIT posiciones).
+     * @param key Clave a buscar.
+     * @param time Tiempo del evento, para decidir qué entradas están inactivas.
+     */
+    KeyWindows& find(unsigned long long key, int time) {
+        size_t hash = (key * 0x9E3779B97F4A7C15ULL) >> 20;
+        KeyWindows* candidate = nullptr; // Posición libre o, si no hay, la clave menos reciente
+        for (int probe = 0; probe < PROBE_LIMIT; ++probe) {
+            KeyWindows& slot = slots[(hash + probe) & mask];
+            if (slot.used && slot.key == key) return slot;
+            if (!candidate || (candidate->used && (!slot.used || slot.lastSeen < candidate->lastSeen))) {
+                candidate = &slot;
+            }
+        }
+
+        if (candidate->used && candidate->lastSeen > time - LONGEST_WINDOW_SECONDS) ++evictions;
+        candidate->key = key;
+        candidate->used = true;
+        candidate->lastSeen = time;
+        candidate->lastAlert = -LONGEST_WINDOW_SECONDS;
+        for (WindowCounter& window : candidate->windows) window.reset();
+        return *candidate;
+    }
+
+    // Claves activas que se reemplazaron por falta de espacio
+    size_t evicted() const { return evictions; }
+};
+
+// Umbrales de la detección
+struct DetectorConfig {
+    uint32_t ipThreshold[WINDOW_COUNT];   // Eventos máximos de una IP en cada ventana
+    uint32_t portThreshold[WINDOW_COUNT]; // Eventos máximos en un puerto en cada ventana
+    double baselineFactor; // Veces la línea base (promedio por minuto de la última hora) para alertar
+    uint32_t baselineMinimum; // Eventos mínimos en el último minuto para comparar con la línea base
+    int cooldown;          // Segundos mínimos entre alertas de la misma clave
+};
+
+// Alerta generada por el detector
+struct Alert {
+    int time;
+    bool isPort;            // true si la clave es un puerto, false si es una IP
+    unsigned long long key; // IP (octetos de 10 bits) o puerto
+    int window;             // Ventana que superó el umbral
+    uint32_t count;         // Eventos en esa ventana
+    double baseline;        // Promedio por minuto en la hora anterior (si la alerta es por línea base)
+};
+
+/*
+ * Detector de ráfagas por IP y por puerto sobre un flujo de eventos en orden de tiempo.
+ * Los eventos ligeramente desordenados se cuentan en su cubeta; los que son más antiguos
+ * que una ventana se descartan en esa ventana.
+ */
+class AnomalyDetector {
+private:
+    DetectorConfig config;
+    WindowTable ips;
+    WindowTable ports;
+    size_t events;
+    size_t lateEvents;
+    int latestTime;
+
+    /*
+     * Registra el evento en los contadores de una clave y revisa los umbrales.
+     * Complejidad: O(1).
+     * @return true si se generó una alerta.
+     */
+    bool update(KeyWindows& entry, int time, const uint32_t thresholds[], Alert& alert) {
+        for (int w = 0; w < WINDOW_COUNT; ++w) entry.windows[w].add(time / BUCKET_SECONDS[w]);
+        if (time > entry.lastSeen) entry.lastSeen = time;
+        if (time < entry.lastAlert + config.cooldown) return false;
+
+        alert.time = time;
+        alert.baseline = 0;
+        for (int w = 0; w < WINDOW_COUNT; ++w) {
+            if (entry.windows[w].total > thresholds[w]) {
+                alert.window = w;
+                alert.count = entry.windows[w].total;
+                entry.lastAlert = time;
+                return true;
+            }
+        }
+
+        // Ráfaga respecto al comportamiento habitual de la misma clave
+        uint32_t lastMinute = entry.windows[0].total;
+        double previousHour = static_cast<double>(entry.windows[WINDOW_COUNT - 1].total) - lastMinute;
+        double baseline = previousHour / (WINDOW_BUCKETS - 1.0);
+        if (lastMinute >= config.baselineMinimum && baseline > 0 && lastMinute > config.baselineFactor * baseline) {
+            alert.window = 0;
+            alert.count = lastMinute;
+            alert.baseline = baseline;
+            entry.lastAlert = time;
+            return true;
+        }
+        return false;
+    }
+
+public:
+    /*
+     * Complejidad: O(c), donde c es la capacidad de las tablas.
+     * @param config Umbrales.
+     * @param ipCapacity Cantidad máxima de IPs activas que se siguen a la vez.
+     * @param portCapacity Cantidad máxima de puertos activos que se siguen a la vez.
+     */
+    AnomalyDetector(const DetectorConfig& config, size_t ipCapacity, size_t portCapacity)
+        : config(config), ips(ipCapacity), ports(portCapacity), events(0), lateEvents(0), latestTime(0) {}
+
+    /*
+     * Registra un acceso y llama a `onAlert(const Alert&)` por cada umbral superado.
+     * Complejidad: O(1).
+     * @param time Segundos desde el inicio del año.
+     * @param ip IP sin puerto (octetos de 10 bits).
+     * @param port Puerto de origen.
+     */
+    template <typename OnAlert>
+    void addEvent(int time, unsigned long long ip, int port, OnAlert onAlert) {
+        ++events;
+        if (time > latestTime) latestTime = time;
+        if (time <= latestTime - WINDOW_BUCKETS * BUCKET_SECONDS[0]) ++lateEvents;
+
+        Alert alert;
+        if (update(ips.find(ip, time), time, config.ipThreshold, alert)) {
+            alert.isPort = false;
+            alert.key = ip;
+            onAlert(alert);
+        }
+        if (update(ports.find(port, time), time, config.portThreshold, alert)) {
+            alert.isPort = true;
+            alert.key = port;
+            onAlert(alert);
+        }
+    }
+
+    size_t eventCount() const { return events; }
+    size_t lateCount() const { return lateEvents; } // Eventos más antiguos que la ventana de 1 min
+    size_t evictedCount() const { return ips.evicted() + ports.evicted(); }
+};
+
+#endif
@@ -0,0 +1,223 @@
+// Header con los algoritmos de ordenamiento y búsqueda parametrizados por la clave
+//
+// Cada política de clave es una estructura con una función estática `get` que obtiene la
+// clave ya calculada del registro. Como la política es un parámetro de plantilla, la
+// comparación se resuelve en compilación (sin funciones virtuales ni interpretar texto
+// en cada comparación). Un nuevo orden es una sola línea, por ejemplo:
+//   using PortThenTime = CompositeKey<PortKey, TimestampKey>;
+//   quickSortBy<PortThenTime>(logs.begin(), logs.end());
+#ifndef SORT_KERNELS_H
+#define SORT_KERNELS_H
+
+#include <algorithm>
+#include <iterator>
+#include <utility>
+
+using namespace std;
+
+// Fecha y hora como segundos desde el inicio del año (campo `timestamp`)
+struct TimestampKey {
+    template <typename Record>
+    static int get(const Record& record) { return record.timestamp; }
+};
+
+// IP y puerto como clave numérica (campo `ipKey`)
+struct IPKey {
+    template <typename Record>
+    static unsigned long long get(const Record& record) { return record.ipKey; }
+};
+
+// Puerto (campo `port`)
+struct PortKey {
+    template <typename Record>
+    static int get(const Record& record) { return record.port; }
+};
+
+// Orden lexicográfico: primero por `First` y en empate por `Second`
+template <typename First, typename Second>
+struct CompositeKey {
+    template <typename Record>
+    static auto get(const Record& record) { return make_pair(First::get(record), Second::get(record)); }
+};
+
+/*
+ * Compara dos registros con la política de clave.
+ * Complejidad: O(1).
+ */
+template <typename Key, typename Record>
+inline bool lessBy(const Record& a, const Record& b) {
+    return Key::get(a) < Key::get(b);
+}
+
+// Tamaño a partir del cual quickSortBy deja de dividir y usa inserción
+const int INSERTION_SORT_THRESHOLD = 16;
+
+/*
+ * Ordenamiento por inserción moviendo los registros (sin copiarlos).
+ * Complejidad: O(n^2), se usa solo en rangos pequeños.
+ */
+template <typename Key, typename It>
+void insertionSortBy(It first, It last) {
+    if (first == last) return;
+    for (It i = next(first); i != last; ++i) {
+        if (lessBy<Key>(*i, *prev(i))) {
+            auto value = move(*i);
+            It j = i;
+            do {
+                *j = move(*prev(j));
+                --j;
+            } while (j != first && Key::get(value) < Key::get(*prev(j)));
+            *j = move(value);
+        }
+    }
+}
+
+/*
+ * Quick Sort con mediana de tres, partición de Hoare e inserción para rangos pequeños.
+ * El pivote se guarda como clave (no como copia del registro) y la recursión se hace
+ * sobre la parte más pequeña, así que la pila es O(log n).
+ * Complejidad: O(n log n) en promedio.
+ * @param first, last Rango [first, last) de iteradores de acceso aleatorio.
+ */
+template <typename Key, typename It>
+void quickSortBy(It first, It last) {
+    while (last - first > INSERTION_SORT_THRESHOLD) {
+        It mid = first + (last - first - 1) / 2;
+        It back = prev(last);
+        if (lessBy<Key>(*mid, *first)) iter_swap(mid, first);
+        if (lessBy<Key>(*back, *mid)) {
+            iter_swap(back, mid);
+            if (lessBy<Key>(*mid, *first)) iter_swap(mid, first);
+        }
+
+        auto pivot = Key::get(*mid);
+        It i = first, j = back;
+        while (true) {
+            while (Key::get(*i) < pivot) ++i;
+            while (pivot < Key::get(*j)) --j;
+            if (i >= j) break;
+            iter_swap(i, j);
+            ++i;
+            --j;
+        }
+
+        It split = next(j);
+        if (split - first < last - split) {
+            quickSortBy<Key>(first, split);
+            first = split;
+        } else {
+            quickSortBy<Key>(split, last);
+            last = split;
+        }
+    }
+    insertionSortBy<Key>(first, last);
+}
+
+/*
+ * Ordenamiento estable: los registros con la misma clave conservan su orden original.
+ * Complejidad: O(n log n).
+ */
+template <typename Key, typename It>
+void stableSortBy(It first, It last) {
+    stable_sort(first, last, [](const auto& a, const auto& b) { return lessBy<Key>(a, b); });
+}
+
+/*
+ * Mezcla dos tramos consecutivos ya ordenados, [first, middle) y [middle, last), en una
+ * sola pasada. Es estable: en empates quedan primero los registros del tramo izquierdo.
+ * Sirve para agregar registros nuevos (ordenados aparte) a un arreglo ya ordenado.
+ * Complejidad: O(n) si hay memoria para un búfer auxiliar; O(n log n) si no.
+ */
+template <typename Key, typename It>
+void inplaceMergeBy(It first, It middle, It last) {
+    inplace_merge(first, middle, last, [](const auto& a, const auto& b) { return lessBy<Key>(a, b); });
+}
+
+/*
+ * Merge Sort estable para listas doblemente enlazadas (nodos con `data`, `next` y `prev`).
+ * Es iterativo (mezclas de tamaño 1, 2, 4, ...), así que no depende del tamaño de la pila,
+ * y solo reacomoda apuntadores.
+ * Complejidad: O(n log n).
+ * @param head Primer nodo de la lista.
+ * @return Primer nodo de la lista ordenada.
+ */
+template <typename Key, typename Node>
+Node* mergeSortListBy(Node* head) {
+    if (!head) return head;
+
+    for (size_t width = 1;; width *= 2) {
+        Node* left = head;
+        Node* tail = nullptr;
+        size_t merges = 0;
+        head = nullptr;
+
+        while (left) {
+            ++merges;
+            Node* right = left;
+            size_t leftSize = 0;
+            while (leftSize < width && right) {
+                ++leftSize;
+                right = right->next;
+            }
+            size_t rightSize = width;
+
+            while (leftSize > 0 || (rightSize > 0 && right)) {
+                Node* chosen;
+                if (leftSize > 0 && (rightSize == 0 || !right || !lessBy<Key>(right->data, left->data))) {
+                    chosen = left;
+                    left = left->next;
+                    --leftSize;
+                } else {
+                    chosen = right;
+                    right = right->next;
+                    --rightSize;
+                }
+                if (tail) tail->next = chosen;
+                else head = chosen;
+                tail = chosen;
+            }
+            left = right;
+        }
+        tail->next = nullptr;
+        if (merges <= 1) break;
+    }
+
+    // Reconstruir los apuntadores al nodo anterior
+    Node* previous = nullptr;
+    for (Node* current = head; current; current = current->next) {
+        current->prev = previous;
+        previous = current;
+    }
+    return head;
+}
+
+/*
+ * Primer registro cuya clave es >= value en un rango ordenado por `Key`.
+ * Complejidad: O(log n).
+ */
+template <typename Key, typename It, typename Value>
+It lowerBoundBy(It first, It last, const Value& value) {
+    return lower_bound(first, last, value, [](const auto& record, const Value& v) { return Key::get(record) < v; });
+}
+
+/*
+ * Primer registro cuya clave es > value en un rango ordenado por `Key`.
+ * Complejidad: O(log n).
+ */
+template <typename Key, typename It, typename Value>
+It upperBoundBy(It first, It last, const Value& value) {
+    return upper_bound(first, last, value, [](const Value& v, const auto& record) { return v < Key::get(record); });
+}
+
+/*
+ * Registros con clave en [low, high] dentro de un rango ordenado por `Key`.
+ * Complejidad: O(log n).
+ * @return Par de iteradores [inicio, fin).
+ */
+template <typename Key, typename It, typename Value>
+pair<It, It> rangeBy(It first, It last, const Value& low, const Value& high) {
+    It begin = lowerBoundBy<Key>(first, last, low);
+    return {begin, upperBoundBy<Key>(begin, last, high)};
+}
+
+#endif
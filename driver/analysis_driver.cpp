@@ -0,0 +1,426 @@
+/*
+ * Programa que ejecuta los análisis de las actividades 1.3, 2.3, 3.4 y 4.3 con una sola
+ * lectura de la bitácora. El archivo se interpreta una vez y los registros se entregan a
+ * etapas de análisis independientes que se ejecutan en paralelo:
+ *  - fecha:   registros ordenados por fecha (sorted_logs.txt, formato de act1.3)
+ *  - ip:      registros ordenados por IP y puerto (sorted_by_ip.txt, formato de act2.3)
+ *  - puerto:  registros ordenados por puerto y después por fecha (sorted_by_port.txt)
+ *  - top:     las 5 IPs con más accesos (act3.4)
+ *  - ataques: puerto más atacado entre 00:00 y 05:00 y posible bot master (act4.3)
+ *
+ * Con --incremental, la bitácora indicada contiene solo registros nuevos: las etapas de
+ * ordenamiento cargan su archivo de la ejecución anterior, ordenan solo los registros
+ * nuevos y los mezclan con los anteriores en una pasada (O(n + m log m) en lugar de
+ * O((n + m) log (n + m))). La etapa top suma los conteos nuevos a los que guardó en
+ * ip_counts.txt, y la etapa ataques agrega los registros nuevos de 00:00 a 05:00 a los
+ * que guardó en attack_records.txt y analiza solo esos. El resultado es el mismo que
+ * analizar las dos bitácoras juntas.
+ *
+ * Compilación (desde la raíz del repositorio):
+ *   g++ -std=c++17 -O2 -pthread driver/analysis_driver.cpp -o analysis_driver
+ * Uso:
+ *   ./analysis_driver [bitacora.txt] [etapas...]
+ *   ./analysis_driver --incremental nuevas.txt [etapas...]
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "../common/attack_graph.h"
+#include "../common/log_record.h"
+#include "../common/sort_kernels.h"
+
+using namespace std;
+
+/*
+ * Etapa de análisis. Cada etapa recibe los registros ya cargados, escribe sus propios
+ * archivos y deja su reporte en `out`, que se imprime al terminar todas las etapas.
+ */
+class AnalysisStage {
+public:
+    virtual ~AnalysisStage() {}
+    virtual string name() const = 0;
+    virtual void run(const LogStore& store, ostream& out) = 0;
+
+    // Actualiza los archivos de una ejecución anterior con registros nuevos.
+    // Regresa false si la etapa necesita la bitácora completa.
+    virtual bool update(const LogStore& /*delta*/, ostream& /*out*/) { return false; }
+};
+
+/*
+ * Ordena los índices de los registros con una política de clave de common/sort_kernels.h
+ * y escribe el archivo resultante. La comparación se especializa en compilación para la clave.
+ * El ordenamiento es estable, así que los empates conservan el orden del archivo.
+ * Complejidad: O(n log n).
+ */
+template <typename Key>
+void writeSortedBy(const LogStore& store, const string& filename) {
+    LargeVector<unsigned> order(store.records.size());
+    for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+    stable_sort(order.begin(), order.end(), [&](unsigned a, unsigned b) {
+        return lessBy<Key>(store.records[a], store.records[b]);
+    });
+
+    ofstream file(filename);
+    if (!file.is_open()) {
+        cerr << "Error al abrir el archivo de salida: " << filename << endl;
+        return;
+    }
+    for (unsigned i : order) writeSortedEntry(file, store, store.records[i]);
+}
+
+/*
+ * Agrega registros nuevos a un archivo ya ordenado por `Key` (la salida de una ejecución
+ * anterior): se carga el archivo, se ordenan solo los registros nuevos y se mezclan con los
+ * anteriores en una sola pasada. En empates quedan primero los anteriores, así que el
+ * resultado es el mismo que ordenar la bitácora anterior seguida de la nueva.
+ * Si el archivo no existe, se crea solo con los registros nuevos.
+ * Complejidad: O(n + m log m), donde n es la cantidad de registros anteriores y m la de nuevos.
+ */
+template <typename Key>
+void updateSortedBy(const LogStore& delta, const string& filename, ostream& out) {
+    LogStore merged;
+    if (!loadSortedStore(filename, merged)) {
+        out << "No se encontró " << filename << "; se crea con los registros nuevos." << endl;
+    }
+    size_t previous = merged.records.size();
+    bool wasSorted = is_sorted(merged.records.begin(), merged.records.end(),
+                               [](const Record& a, const Record& b) { return lessBy<Key>(a, b); });
+    appendLogStore(merged, delta);
+
+    auto middle = merged.records.begin() + previous;
+    stableSortBy<Key>(middle, merged.records.end());
+    if (wasSorted) {
+        inplaceMergeBy<Key>(merged.records.begin(), middle, merged.records.end());
+    } else {
+        out << "El archivo " << filename << " no estaba ordenado; se ordenó completo." << endl;
+        stableSortBy<Key>(merged.records.begin(), merged.records.end());
+    }
+
+    // Se escribe en un archivo aparte y se reemplaza al final, para no perder el anterior si falla
+    string temporary = filename + ".tmp";
+    {
+        ofstream file(temporary);
+        if (!file.is_open()) {
+            cerr << "Error al abrir el archivo de salida: " << temporary << endl;
+            return;
+        }
+        for (const Record& record : merged.records) writeSortedEntry(file, merged, record);
+    }
+    if (rename(temporary.c_str(), filename.c_str()) != 0) {
+        cerr << "Error al reemplazar el archivo: " << filename << endl;
+        return;
+    }
+    out << "Registros anteriores: " << previous << " - nuevos: " << delta.records.size() << endl;
+}
+
+// Etapa que escribe los registros ordenados por la clave `Key`
+template <typename Key>
+class SortStage : public AnalysisStage {
+private:
+    string stageName;
+    string filename;
+    string description;
+
+public:
+    SortStage(const string& stageName, const string& filename, const string& description)
+        : stageName(stageName), filename(filename), description(description) {}
+    string name() const override { return stageName; }
+    void run(const LogStore& store, ostream& out) override {
+        writeSortedBy<Key>(store, filename);
+        out << description << filename << endl;
+    }
+    bool update(const LogStore& delta, ostream& out) override {
+        updateSortedBy<Key>(delta, filename, out);
+        out << description << filename << endl;
+        return true;
+    }
+};
+
+// Conteo de accesos por IP: (-accesos, IP), ordenado con la mayor cantidad primero y,
+// en empate, la IP en orden alfabético (igual que act3.4)
+typedef vector<pair<int, string>> IPCounts;
+
+/*
+ * Convierte la clave de IP sin puerto (octetos de 10 bits) a texto "a.b.c.d".
+ * Complejidad: O(1).
+ */
+string formatIPKey(unsigned long long key) {
+    string ip;
+    for (int octet = 0; octet < 4; ++octet) {
+        if (octet > 0) ip += '.';
+        ip += to_string((key >> (10 * (3 - octet))) & 1023);
+    }
+    return ip;
+}
+
+/*
+ * Cuenta los accesos de cada IP (sin puerto) de los registros.
+ * Complejidad: O(n + u log u), donde u es la cantidad de IPs distintas.
+ */
+IPCounts countIPs(const LargeVector<Record>& records) {
+    unordered_map<unsigned long long, int> ipCount;
+    for (const Record& record : records) ipCount[record.ipKey >> 16]++;
+    IPCounts counts;
+    counts.reserve(ipCount.size());
+    for (const auto& entry : ipCount) counts.push_back({-entry.second, formatIPKey(entry.first)});
+    sort(counts.begin(), counts.end());
+    return counts;
+}
+
+/*
+ * Carga los conteos guardados por saveIPCounts (líneas "IP accesos").
+ * Complejidad: O(u), donde u es la cantidad de IPs.
+ * @return false si el archivo no existe o no tiene ese formato.
+ */
+bool loadIPCounts(const string& filename, IPCounts& counts) {
+    ifstream file(filename);
+    if (!file.is_open()) return false;
+    string ip;
+    int accesses;
+    while (file >> ip >> accesses) counts.push_back({-accesses, ip});
+    return file.eof() && is_sorted(counts.begin(), counts.end());
+}
+
+/*
+ * Guarda los conteos (en un archivo aparte que reemplaza al anterior al final).
+ * Complejidad: O(u), donde u es la cantidad de IPs.
+ */
+void saveIPCounts(const string& filename, const IPCounts& counts) {
+    string temporary = filename + ".tmp";
+    {
+        ofstream file(temporary);
+        if (!file.is_open()) {
+            cerr << "Error al abrir el archivo de salida: " << temporary << endl;
+            return;
+        }
+        for (const auto& entry : counts) file << entry.second << ' ' << -entry.first << '\n';
+    }
+    if (rename(temporary.c_str(), filename.c_str()) != 0) {
+        cerr << "Error al reemplazar el archivo: " << filename << endl;
+    }
+}
+
+// Etapa de act3.4: las k IPs (sin puerto) con más accesos. Guarda el conteo de todas las
+// IPs para que el modo incremental solo sume los registros nuevos.
+class TopIPsStage : public AnalysisStage {
+private:
+    int k;
+    string filename;
+
+    void report(const IPCounts& counts, ostream& out) const {
+        int top = min<int>(k, counts.size());
+        out << "Top " << k << " IPs con más accesos:" << endl;
+        for (int i = 0; i < top; ++i) {
+            out << "IP: " << counts[i].second << " - Accesos: " << -counts[i].first << endl;
+        }
+    }
+
+public:
+    TopIPsStage(int k, const string& filename) : k(k), filename(filename) {}
+    string name() const override { return "top"; }
+    void run(const LogStore& store, ostream& out) override {
+        IPCounts counts = countIPs(store.records);
+        saveIPCounts(filename, counts);
+        report(counts, out);
+    }
+
+    // Las IPs sin registros nuevos conservan su orden; solo se ordenan las que cambiaron
+    // y se mezclan con las demás (igual que extendSnapshot del servicio de consultas).
+    // Complejidad: O(u + c log c), donde c es la cantidad de IPs con registros nuevos.
+    bool update(const LogStore& delta, ostream& out) override {
+        IPCounts previous;
+        if (!loadIPCounts(filename, previous)) {
+            out << "No se encontró " << filename << "; se crea con los registros nuevos." << endl;
+            previous.clear();
+        }
+        unordered_map<string, int> newAccesses;
+        for (const auto& entry : countIPs(delta.records)) newAccesses[entry.second] = -entry.first;
+
+        IPCounts unchanged, changed;
+        for (const auto& entry : previous) {
+            auto found = newAccesses.find(entry.second);
+            if (found == newAccesses.end()) {
+                unchanged.push_back(entry);
+            } else {
+                changed.push_back({entry.first - found->second, entry.second});
+                newAccesses.erase(found);
+            }
+        }
+        for (const auto& entry : newAccesses) changed.push_back({-entry.second, entry.first});
+        sort(changed.begin(), changed.end());
+        IPCounts counts(unchanged.size() + changed.size());
+        merge(unchanged.begin(), unchanged.end(), changed.begin(), changed.end(), counts.begin());
+
+        saveIPCounts(filename, counts);
+        out << "IPs anteriores: " << previous.size() << " - con registros nuevos: " << changed.size() << endl;
+        report(counts, out);
+        return true;
+    }
+};
+
+// Etapa de act4.3: grafo puerto -> IPs atacantes entre 00:00 y 05:00 (CSR, construido en paralelo)
+// y detección del bot master.
+// Se mantienen juntas porque el bot master se busca entre los registros del puerto más atacado.
+// Las líneas de 00:00 a 05:00 (las únicas que usa el análisis) se guardan tal como vienen en
+// la bitácora, así que el modo incremental solo agrega las nuevas y analiza ese archivo.
+class PortAttackStage : public AnalysisStage {
+private:
+    string filename;
+
+    static bool suspicious(const Record& record) { return record.hour < 5; }
+
+    // Escribe las líneas sospechosas de `store`, en el orden de la bitácora
+    static bool writeSuspicious(ofstream& file, const LogStore& store) {
+        for (const Record& record : store.records) {
+            if (!suspicious(record)) continue;
+            size_t end = record.message.offset + record.message.length;
+            file << string_view(store.buffer.data() + record.month.offset, end - record.month.offset) << '\n';
+        }
+        return file.good();
+    }
+
+    void report(const LogStore& store, ostream& out) const {
+        AttackGraph graph = buildAttackGraph(store.records, [](const Record& record, AttackEdge& edge) {
+            edge = {record.port, record.ipKey, uint8_t(0)};
+            return suspicious(record);
+        });
+
+        int mostAttackedPort = -1;
+        size_t maxFanOut = 0;
+        for (size_t i = 0; i < graph.ports.size(); ++i) {
+            if (graph.fanOut(i) > maxFanOut) {
+                maxFanOut = graph.fanOut(i);
+                mostAttackedPort = graph.ports[i];
+            }
+        }
+
+        out << "\nPuerto más atacado en horas sospechosas: " << mostAttackedPort << " con " << maxFanOut
+            << " IPs atacantes distintas." << endl;
+        out << "\nRegistros asociados a este puerto:" << endl;
+
+        string_view possibleBotMaster;
+        for (const Record& record : store.records) {
+            if (!suspicious(record) || record.port != mostAttackedPort) continue;
+            string_view message = store.view(record.message);
+            out << store.view(record.month) << "-" << store.view(record.day) << " " << store.view(record.time)
+                << " " << store.view(record.ip) << " - " << message << '\n';
+            if (message.find("admin") != string_view::npos) possibleBotMaster = store.view(record.ip);
+        }
+
+        if (!possibleBotMaster.empty()) {
+            out << "\nPosible Bot Master: " << possibleBotMaster << " intentó acceder como admin." << endl;
+        } else {
+            out << "\nNo se encontró un intento de acceso a 'admin'." << endl;
+        }
+    }
+
+public:
+    explicit PortAttackStage(const string& filename) : filename(filename) {}
+    string name() const override { return "ataques"; }
+    void run(const LogStore& store, ostream& out) override {
+        ofstream file(filename);
+        if (!file.is_open() || !writeSuspicious(file, store)) {
+            cerr << "Error al escribir el archivo: " << filename << endl;
+        }
+        report(store, out);
+    }
+
+    // Complejidad: O(s + m), donde s es la cantidad de líneas sospechosas anteriores y m la
+    // de registros nuevos (en lugar de O(n) con la bitácora completa).
+    bool update(const LogStore& delta, ostream& out) override {
+        if (!ifstream(filename).is_open()) {
+            out << "No se encontró " << filename << "; se crea con los registros nuevos." << endl;
+        }
+        {
+            ofstream file(filename, ios::app);
+            if (!file.is_open() || !writeSuspicious(file, delta)) {
+                cerr << "Error al escribir el archivo: " << filename << endl;
+                return true;
+            }
+        }
+        LogStore suspiciousStore;
+        if (!loadLogStore(filename, suspiciousStore)) {
+            cerr << "Error al abrir el archivo: " << filename << endl;
+            return true;
+        }
+        report(suspiciousStore, out);
+        return true;
+    }
+};
+
+/*
+ * Ejecuta las etapas en paralelo sobre los mismos registros y después imprime sus
+ * reportes en el orden en que fueron registradas. Con `incremental`, los registros son
+ * nuevos y cada etapa actualiza los archivos de la ejecución anterior.
+ * Complejidad: la de la etapa más costosa (si hay suficientes núcleos).
+ */
+void runStages(const LogStore& store, const vector<unique_ptr<AnalysisStage>>& stages, bool incremental) {
+    vector<ostringstream> reports(stages.size());
+    vector<thread> workers;
+    for (size_t i = 0; i < stages.size(); ++i) {
+        workers.emplace_back([&, i]() {
+            if (!incremental) {
+                stages[i]->run(store, reports[i]);
+            } else if (!stages[i]->update(store, reports[i])) {
+                reports[i] << "Esta etapa necesita la bitácora completa (ejecutar sin --incremental)." << endl;
+            }
+        });
+    }
+    for (thread& worker : workers) worker.join();
+
+    for (size_t i = 0; i < stages.size(); ++i) {
+        cout << "== " << stages[i]->name() << " ==" << endl << reports[i].str() << endl;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    bool incremental = argc > 1 && string(argv[1]) == "--incremental";
+    if (incremental && argc < 3) {
+        cerr << "Uso: " << argv[0] << " [bitacora.txt] [etapas...]" << endl
+             << "     " << argv[0] << " --incremental nuevas.txt [etapas...]" << endl;
+        return 1;
+    }
+    string filename = incremental ? argv[2] : argc > 1 ? argv[1] : "bitacora.txt";
+    int firstStage = incremental ? 3 : 2;
+
+    // Etapas disponibles; si se indican nombres en la línea de comandos solo se ejecutan esas
+    vector<unique_ptr<AnalysisStage>> available;
+    available.emplace_back(new SortStage<TimestampKey>(
+        "fecha", "sorted_logs.txt", "Registros ordenados guardados en el archivo: "));
+    available.emplace_back(new SortStage<IPKey>("ip", "sorted_by_ip.txt", "Registros ordenados por IP guardados en: "));
+    available.emplace_back(new SortStage<CompositeKey<PortKey, TimestampKey>>(
+        "puerto", "sorted_by_port.txt", "Registros ordenados por puerto guardados en: "));
+    available.emplace_back(new TopIPsStage(5, "ip_counts.txt"));
+    available.emplace_back(new PortAttackStage("attack_records.txt"));
+
+    vector<unique_ptr<AnalysisStage>> stages;
+    for (auto& stage : available) {
+        bool selected = argc <= firstStage;
+        for (int i = firstStage; i < argc; ++i) selected = selected || stage->name() == argv[i];
+        if (selected) stages.push_back(move(stage));
+    }
+
+    // Una sola lectura e interpretación de la bitácora
+    LogStore store;
+    if (!loadLogStore(filename, store)) {
+        cerr << "Error al abrir el archivo: " << filename << endl;
+        return 1;
+    }
+    if (store.records.empty()) {
+        cout << "No se encontraron registros para procesar." << endl;
+        return 1;
+    }
+
+    runStages(store, stages, incremental);
+    return 0;
+}
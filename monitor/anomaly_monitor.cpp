@@ -0,0 +1,176 @@
+/*
+ * Monitor de ráfagas de accesos sobre una bitácora, registro por registro.
+ * A diferencia de act4.3 (que analiza el archivo completo al final), cada línea se
+ * procesa al leerse con contadores en ventanas deslizantes de 1 min, 10 min y 1 h por
+ * IP y por puerto (common/sliding_window.h). Se alerta cuando una IP o un puerto supera
+ * un umbral fijo o cuando su último minuto supera varias veces su promedio de la hora.
+ * La memoria es fija y cada registro cuesta O(1), así que puede seguir una bitácora
+ * que sigue creciendo.
+ *
+ * Compilación (desde la raíz del repositorio):
+ *   g++ -std=c++17 -O2 monitor/anomaly_monitor.cpp -o anomaly_monitor
+ * Uso:
+ *   ./anomaly_monitor [bitacora.txt | -] [--seguir]
+ * Con --seguir el programa no termina al llegar al final del archivo y espera nuevas líneas.
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include "../common/log_tokenizer.h"
+#include "../common/sliding_window.h"
+
+using namespace std;
+
+// Días transcurridos antes de cada mes (1-12), en un año bisiesto
+const int DAYS_BEFORE_MONTH[13] = {0, 0, 31, 60, 91, 121, 152, 182, 213, 244, 274, 305, 335};
+
+// Capacidad de las tablas de contadores (IPs y puertos activos a la vez)
+const size_t IP_CAPACITY = 1 << 16;
+const size_t PORT_CAPACITY = 1 << 14;
+
+// Tamaño de cada lectura del archivo
+const size_t READ_SIZE = 1 << 16;
+
+// Umbrales por ventana (1 min, 10 min, 1 h)
+const DetectorConfig DEFAULT_CONFIG = {
+    {20, 60, 200},   // Una IP
+    {60, 200, 1000}, // Un puerto
+    5.0,             // Veces el promedio por minuto de la hora anterior
+    10,              // Eventos mínimos en el último minuto para usar la línea base
+    60,              // Segundos entre alertas de la misma IP o puerto
+};
+
+/*
+ * Interpreta una línea "Mes día hh:mm:ss IP:puerto mensaje".
+ * Complejidad: O(k), donde k es la longitud de la línea.
+ * @param time Segundos desde el inicio del año.
+ * @param ip IP sin puerto (octetos de 10 bits).
+ * @param port Puerto de origen.
+ * @return false si la línea está vacía o incompleta.
+ */
+bool parseEvent(const char* line, size_t length, int& time, unsigned long long& ip, int& port) {
+    LineTokens tokens;
+    if (!tokenizeLine(line, length, tokens)) return false;
+
+    int month = monthFromName(line + tokens.start[0], tokens.end[0] - tokens.start[0]);
+    const char* day = line + tokens.start[1];
+    int dayNumber = readNumber(day, line + tokens.end[1]);
+    int hour = 0, minute = 0, second = 0;
+    parseClock(line + tokens.start[2], tokens.end[2] - tokens.start[2], hour, minute, second);
+    if (month == 0 || dayNumber == 0) return false;
+    time = (((DAYS_BEFORE_MONTH[month] + dayNumber - 1) * 24 + hour) * 60 + minute) * 60 + second;
+
+    int octets[4];
+    parseIPPort(line + tokens.start[3], line + length, octets, port);
+    ip = 0;
+    for (int octet : octets) ip = (ip << 10) | (octet & 1023);
+    return true;
+}
+
+/*
+ * Convierte un tiempo en segundos desde el inicio del año a "MM-DD hh:mm:ss".
+ * Complejidad: O(1).
+ */
+string formatTime(int time) {
+    int dayOfYear = time / 86400;
+    int month = 12;
+    while (month > 1 && DAYS_BEFORE_MONTH[month] > dayOfYear) --month;
+    char text[32];
+    snprintf(text, sizeof(text), "%02d-%02d %02d:%02d:%02d", month, dayOfYear - DAYS_BEFORE_MONTH[month] + 1,
+             time / 3600 % 24, time / 60 % 60, time % 60);
+    return text;
+}
+
+/*
+ * Imprime una alerta del detector.
+ * Complejidad: O(1).
+ */
+void printAlert(const Alert& alert, const DetectorConfig& config) {
+    cout << "ALERTA " << formatTime(alert.time) << ' ';
+    if (alert.isPort) {
+        cout << "puerto " << alert.key;
+    } else {
+        cout << "IP ";
+        for (int octet = 0; octet < 4; ++octet) {
+            cout << (octet > 0 ? "." : "") << ((alert.key >> (10 * (3 - octet))) & 1023);
+        }
+    }
+    cout << " - " << alert.count << " accesos en " << WINDOW_NAMES[alert.window];
+    if (alert.baseline > 0) {
+        cout << " (" << alert.count / alert.baseline << " veces su promedio por minuto)";
+    } else {
+        uint32_t threshold = alert.isPort ? config.portThreshold[alert.window] : config.ipThreshold[alert.window];
+        cout << " (umbral " << threshold << ")";
+    }
+    cout << endl;
+}
+
+int main(int argc, char* argv[]) {
+    string filename = "bitacora.txt";
+    bool follow = false;
+    for (int i = 1; i < argc; ++i) {
+        string argument = argv[i];
+        if (argument == "--seguir") follow = true;
+        else filename = argument;
+    }
+
+    ifstream file;
+    istream* input = &cin;
+    if (filename != "-") {
+        file.open(filename, ios::binary);
+        if (!file.is_open()) {
+            cerr << "Error al abrir el archivo: " << filename << endl;
+            return 1;
+        }
+        input = &file;
+    }
+
+    AnomalyDetector detector(DEFAULT_CONFIG, IP_CAPACITY, PORT_CAPACITY);
+    size_t alerts = 0;
+    auto onAlert = [&alerts](const Alert& alert) {
+        ++alerts;
+        printAlert(alert, DEFAULT_CONFIG);
+    };
+
+    // Se lee por bloques y solo se guarda la línea incompleta del final de cada bloque
+    string pending;
+    char block[READ_SIZE];
+    while (true) {
+        input->read(block, sizeof(block));
+        size_t count = input->gcount();
+        if (count == 0) {
+            if (!follow || input == &cin) break;
+            input->clear(); // Esperar a que la bitácora crezca
+            this_thread::sleep_for(chrono::milliseconds(200));
+            continue;
+        }
+
+        pending.append(block, count);
+        size_t lineStart = 0;
+        size_t lineEnd;
+        while ((lineEnd = pending.find('\n', lineStart)) != string::npos) {
+            int time, port;
+            unsigned long long ip;
+            if (parseEvent(pending.data() + lineStart, lineEnd - lineStart, time, ip, port)) {
+                detector.addEvent(time, ip, port, onAlert);
+            }
+            lineStart = lineEnd + 1;
+        }
+        pending.erase(0, lineStart);
+    }
+
+    // Última línea sin salto de línea
+    int time, port;
+    unsigned long long ip;
+    if (parseEvent(pending.data(), pending.size(), time, ip, port)) detector.addEvent(time, ip, port, onAlert);
+
+    cout << "Registros procesados: " << detector.eventCount() << ", alertas: " << alerts
+         << ", registros fuera de orden: " << detector.lateCount()
+         << ", contadores reemplazados: " << detector.evictedCount() << endl;
+    return 0;
+}
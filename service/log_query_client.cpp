@@ -0,0 +1,141 @@
+/*
+ * Cliente del servicio de consultas de bitácora (service/log_query_server.cpp).
+ * Envía la consulta de los argumentos, o una consulta por cada línea de la entrada
+ * estándar, e imprime las respuestas. Con --medir repite cada consulta n veces e
+ * informa la latencia promedio y la mínima.
+ *
+ * Compilación (desde la raíz del repositorio):
+ *   g++ -std=c++17 -O2 service/log_query_client.cpp -o log_query_client
+ * Uso:
+ *   ./log_query_client [--socket ruta | --tcp puerto] [--medir n] [consulta...]
+ * Ejemplos:
+ *   ./log_query_client FECHAS 08-01 08-03
+ *   ./log_query_client --medir 1000 TOP 5
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using namespace std;
+
+const char* const DEFAULT_SOCKET_PATH = "/tmp/bitacora.sock";
+
+/*
+ * Se conecta al servicio: por socket Unix en `socketPath`, o por TCP a 127.0.0.1 si `tcpPort` > 0.
+ * Complejidad: O(1).
+ * @return Descriptor de la conexión, o -1 si no se pudo conectar.
+ */
+int connectToService(const string& socketPath, int tcpPort) {
+    int connection;
+    int status;
+    if (tcpPort > 0) {
+        connection = socket(AF_INET, SOCK_STREAM, 0);
+        if (connection < 0) return -1;
+        sockaddr_in address = {};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        address.sin_port = htons(tcpPort);
+        status = connect(connection, reinterpret_cast<sockaddr*>(&address), sizeof(address));
+    } else {
+        connection = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (connection < 0) return -1;
+        sockaddr_un address = {};
+        address.sun_family = AF_UNIX;
+        strncpy(address.sun_path, socketPath.c_str(), sizeof(address.sun_path) - 1);
+        status = connect(connection, reinterpret_cast<sockaddr*>(&address), sizeof(address));
+    }
+    if (status != 0) {
+        close(connection);
+        return -1;
+    }
+    return connection;
+}
+
+/*
+ * Envía una consulta y lee su respuesta hasta la línea "FIN" (que no se incluye).
+ * Complejidad: O(k), donde k es el tamaño de la respuesta.
+ * @return false si la conexión se cerró antes de terminar la respuesta.
+ */
+bool sendQuery(int connection, const string& query, string& response) {
+    string request = query + '\n';
+    for (size_t sent = 0; sent < request.size();) {
+        ssize_t written = send(connection, request.data() + sent, request.size() - sent, MSG_NOSIGNAL);
+        if (written <= 0) return false;
+        sent += written;
+    }
+
+    response.clear();
+    char block[65536];
+    while (true) {
+        size_t length = response.size();
+        if (length >= 4 && response.compare(length - 4, 4, "FIN\n") == 0 &&
+            (length == 4 || response[length - 5] == '\n')) {
+            response.resize(length - 4);
+            return true;
+        }
+        ssize_t received = recv(connection, block, sizeof(block), 0);
+        if (received <= 0) return false;
+        response.append(block, received);
+    }
+}
+
+int main(int argc, char* argv[]) {
+    string socketPath = DEFAULT_SOCKET_PATH;
+    int tcpPort = 0;
+    long repetitions = 0;
+    string query;
+    for (int i = 1; i < argc; ++i) {
+        string argument = argv[i];
+        if (query.empty() && argument == "--socket" && i + 1 < argc) socketPath = argv[++i];
+        else if (query.empty() && argument == "--tcp" && i + 1 < argc) tcpPort = atoi(argv[++i]);
+        else if (query.empty() && argument == "--medir" && i + 1 < argc) repetitions = max(1, atoi(argv[++i]));
+        else query += (query.empty() ? "" : " ") + argument;
+    }
+
+    int connection = connectToService(socketPath, tcpPort);
+    if (connection < 0) {
+        cerr << "Error al conectar con el servicio: " << strerror(errno) << endl;
+        return 1;
+    }
+
+    bool fromInput = query.empty();
+    string response;
+    while (!fromInput || getline(cin, query)) {
+        if (!query.empty()) {
+            auto start = chrono::steady_clock::now();
+            if (!sendQuery(connection, query, response)) {
+                cerr << "La conexión se cerró antes de terminar la respuesta" << endl;
+                close(connection);
+                return 1;
+            }
+            cout << response;
+
+            if (repetitions > 0) {
+                double best = chrono::duration<double, micro>(chrono::steady_clock::now() - start).count();
+                double total = 0;
+                for (long i = 0; i < repetitions; ++i) {
+                    auto repeated = chrono::steady_clock::now();
+                    sendQuery(connection, query, response);
+                    double elapsed = chrono::duration<double, micro>(chrono::steady_clock::now() - repeated).count();
+                    total += elapsed;
+                    best = min(best, elapsed);
+                }
+                cerr << "Latencia de \"" << query << "\": promedio " << total / repetitions << " us, mínima "
+                     << best << " us (" << repetitions << " repeticiones)" << endl;
+            }
+        }
+        if (!fromInput) break;
+    }
+    close(connection);
+    return 0;
+}
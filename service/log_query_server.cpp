@@ -0,0 +1,657 @@
+/*
+ * Servicio local de consultas sobre una bitácora cargada en memoria.
+ * La bitácora se carga e indexa una sola vez (registros ordenados por fecha y por IP,
+ * conteo de accesos por IP y grafo puerto -> atacantes) y las consultas se responden
+ * desde un grupo de hilos sobre esos datos inmutables. Al cargar otra bitácora, los
+ * índices nuevos se construyen aparte y se publican con un intercambio atómico: las
+ * consultas en curso terminan con la versión anterior. Al agregar una bitácora con registros
+ * nuevos, los índices vigentes se actualizan (mezcla lineal con los registros nuevos ya
+ * ordenados y suma de conteos) en lugar de construirse desde cero.
+ * Un solo hilo espera con poll a todas las conexiones y entrega cada consulta completa al
+ * grupo de hilos, así que los clientes inactivos no ocupan hilos; las respuestas de una
+ * misma conexión salen en el orden de sus consultas.
+ *
+ * Protocolo (una consulta por línea; cada respuesta termina con la línea "FIN"):
+ *   FECHAS MM-DD [hh[:mm[:ss]]] MM-DD [hh[:mm[:ss]]]   registros en el rango de fechas
+ *   IPS a.b.c.d[:puerto] a.b.c.d[:puerto]              registros en el rango de IPs
+ *   TOP k                                             las k IPs con más accesos
+ *   PUERTO p                                          atacantes distintos del puerto p
+ *   PUERTOS k                                         los k puertos con más atacantes distintos
+ *   ESTADO                                            bitácora cargada y tamaño de los índices
+ *   CARGAR archivo                                    carga otra bitácora y la publica
+ *   AGREGAR archivo                                   agrega los registros nuevos de otra bitácora
+ * Los errores se responden con una línea "ERROR mensaje".
+ *
+ * Compilación (desde la raíz del repositorio):
+ *   g++ -std=c++17 -O2 -pthread service/log_query_server.cpp -o log_query_server
+ * Uso:
+ *   ./log_query_server [bitacora.txt] [--socket ruta | --tcp puerto] [--hilos n]
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cerrno>
+#include <condition_variable>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "../common/attack_graph.h"
+#include "../common/log_record.h"
+#include "../common/sort_kernels.h"
+
+using namespace std;
+
+const char* const DEFAULT_SOCKET_PATH = "/tmp/bitacora.sock";
+
+// Bitácora cargada con sus índices. No cambia después de construirse.
+struct LogSnapshot {
+    string filename;
+    LogStore store;
+    LargeVector<Record> byTime;            // Registros ordenados por fecha (estable)
+    LargeVector<Record> byIP;              // Registros ordenados por IP y puerto
+    vector<pair<int, string>> topIPs;      // (-accesos, IP sin puerto), de más a menos accesos
+    AttackGraph graph;                     // Puerto -> atacantes distintos
+    vector<uint32_t> portsByFanOut;        // Posiciones de los puertos, de más a menos atacantes
+    double loadMilliseconds;
+};
+
+/*
+ * Convierte la clave numérica de una IP (octetos de 10 bits, sin puerto) a texto.
+ * Complejidad: O(1).
+ */
+string formatIP(unsigned long long ip) {
+    string text;
+    for (int octet = 0; octet < 4; ++octet) {
+        if (octet > 0) text += '.';
+        text += to_string((ip >> (10 * (3 - octet))) & 1023);
+    }
+    return text;
+}
+
+/*
+ * Ordena los puertos del grafo de más a menos atacantes distintos.
+ * Complejidad: O(p log p), donde p es la cantidad de puertos.
+ */
+void indexPortsByFanOut(LogSnapshot& snapshot) {
+    const AttackGraph& graph = snapshot.graph;
+    snapshot.portsByFanOut.resize(graph.ports.size());
+    for (size_t i = 0; i < graph.ports.size(); ++i) snapshot.portsByFanOut[i] = i;
+    stable_sort(snapshot.portsByFanOut.begin(), snapshot.portsByFanOut.end(),
+                [&graph](uint32_t a, uint32_t b) { return graph.fanOut(a) > graph.fanOut(b); });
+}
+
+// Arista de cada registro en el grafo del servicio: todos los accesos cuentan
+bool serviceEdge(const Record& record, AttackEdge& edge) {
+    edge = {record.port, record.ipKey, uint8_t(0)};
+    return true;
+}
+
+/*
+ * Carga una bitácora y construye todos los índices.
+ * Complejidad: O(n log n).
+ * @return nullptr si el archivo no se pudo abrir.
+ */
+shared_ptr<const LogSnapshot> loadSnapshot(const string& filename) {
+    auto start = chrono::steady_clock::now();
+    shared_ptr<LogSnapshot> snapshot = make_shared<LogSnapshot>();
+    snapshot->filename = filename;
+    if (!loadLogStore(filename, snapshot->store)) return nullptr;
+    const LargeVector<Record>& records = snapshot->store.records;
+
+    snapshot->byTime = records;
+    stableSortBy<TimestampKey>(snapshot->byTime.begin(), snapshot->byTime.end());
+    snapshot->byIP = records;
+    stableSortBy<IPKey>(snapshot->byIP.begin(), snapshot->byIP.end());
+
+    // Igual que act3.4: más accesos primero y, en empate, la IP en orden alfabético
+    unordered_map<unsigned long long, int> ipCount;
+    for (const Record& record : records) ipCount[record.ipKey >> 16]++;
+    for (const auto& entry : ipCount) snapshot->topIPs.push_back({-entry.second, formatIP(entry.first)});
+    sort(snapshot->topIPs.begin(), snapshot->topIPs.end());
+
+    snapshot->graph = buildAttackGraph(records, serviceEdge);
+    indexPortsByFanOut(*snapshot);
+
+    snapshot->loadMilliseconds = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    return snapshot;
+}
+
+/*
+ * Agrega los registros nuevos de `delta` a un índice ordenado por `Key`: se ordenan solo
+ * los nuevos y se mezclan con los anteriores en una pasada (en empates, primero los anteriores).
+ * Complejidad: O(n + m log m), donde m es la cantidad de registros nuevos.
+ */
+template <typename Key, typename It>
+void extendIndex(LargeVector<Record>& index, It deltaFirst, It deltaLast) {
+    size_t previous = index.size();
+    index.insert(index.end(), deltaFirst, deltaLast);
+    stableSortBy<Key>(index.begin() + previous, index.end());
+    inplaceMergeBy<Key>(index.begin(), index.begin() + previous, index.end());
+}
+
+/*
+ * Construye una versión nueva con los registros de la vigente más los de otra bitácora,
+ * actualizando los índices en lugar de reconstruirlos:
+ *  - los índices por fecha y por IP se mezclan con los registros nuevos ya ordenados;
+ *  - los conteos por IP solo cambian para las IPs de los registros nuevos;
+ *  - el grafo se une con el grafo de los registros nuevos (ver unionAttackGraphs).
+ * El resultado es el mismo que cargar las dos bitácoras juntas.
+ * Complejidad: O(n + m log m + u), donde n es la cantidad de registros vigentes, m la de
+ * nuevos y u la de IPs distintas.
+ * @return nullptr si el archivo no se pudo abrir.
+ */
+shared_ptr<const LogSnapshot> extendSnapshot(const LogSnapshot& current, const string& filename) {
+    auto start = chrono::steady_clock::now();
+    LogStore delta;
+    if (!loadLogStore(filename, delta)) return nullptr;
+
+    shared_ptr<LogSnapshot> snapshot = make_shared<LogSnapshot>();
+    snapshot->filename = current.filename + " + " + filename;
+    snapshot->store.buffer.reserve(current.store.buffer.size() + delta.buffer.size());
+    snapshot->store.buffer.append(current.store.buffer);
+    snapshot->store.records = current.store.records;
+    size_t previous = current.store.records.size();
+    appendLogStore(snapshot->store, delta);
+    auto added = snapshot->store.records.begin() + previous;
+
+    snapshot->byTime = current.byTime;
+    extendIndex<TimestampKey>(snapshot->byTime, added, snapshot->store.records.end());
+    snapshot->byIP = current.byIP;
+    extendIndex<IPKey>(snapshot->byIP, added, snapshot->store.records.end());
+
+    // Las IPs sin registros nuevos conservan su orden; solo se ordenan las que cambiaron
+    unordered_map<unsigned long long, int> deltaCount;
+    for (const Record& record : delta.records) deltaCount[record.ipKey >> 16]++;
+    unordered_map<string, int> newAccesses;
+    for (const auto& entry : deltaCount) newAccesses[formatIP(entry.first)] = entry.second;
+    vector<pair<int, string>> unchanged, changed;
+    for (const pair<int, string>& entry : current.topIPs) {
+        auto found = newAccesses.find(entry.second);
+        if (found == newAccesses.end()) {
+            unchanged.push_back(entry);
+        } else {
+            changed.push_back({entry.first - found->second, entry.second});
+            newAccesses.erase(found);
+        }
+    }
+    for (const auto& entry : newAccesses) changed.push_back({-entry.second, entry.first});
+    sort(changed.begin(), changed.end());
+    snapshot->topIPs.resize(unchanged.size() + changed.size());
+    merge(unchanged.begin(), unchanged.end(), changed.begin(), changed.end(), snapshot->topIPs.begin());
+
+    AttackGraph deltaGraph = buildAttackGraph(delta.records, serviceEdge);
+    snapshot->graph = unionAttackGraphs({current.graph.view(), deltaGraph.view()});
+    indexPortsByFanOut(*snapshot);
+
+    snapshot->loadMilliseconds = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    return snapshot;
+}
+
+/*
+ * Convierte "MM-DD" y una hora opcional "hh[:mm[:ss]]" a segundos desde el inicio del año.
+ * Sin hora, el inicio de un rango es 00:00:00 y el fin 23:59:59.
+ * Complejidad: O(1).
+ * @return false si la fecha o la hora no son válidas.
+ */
+bool parseQueryTime(const string& date, const string& time, bool isEnd, int& timestamp) {
+    int month, day, hour = isEnd ? 23 : 0, minute = isEnd ? 59 : 0, second = isEnd ? 59 : 0;
+    char separator;
+    istringstream dateStream(date);
+    if (!(dateStream >> month >> separator >> day) || separator != '-' || month < 1 || month > 12 || day < 1 ||
+        day > 31) {
+        return false;
+    }
+    if (!time.empty()) {
+        minute = second = 0;
+        int* parts[] = {&hour, &minute, &second};
+        istringstream timeStream(time);
+        for (int i = 0; i < 3 && timeStream >> *parts[i]; ++i) {
+            if (timeStream.peek() == ':') timeStream.get();
+        }
+        if (hour < 0 || hour > 23 || minute < 0 || minute > 59 || second < 0 || second > 59) return false;
+    }
+    timestamp = (((DAYS_BEFORE_MONTH[month] + day - 1) * 24 + hour) * 60 + minute) * 60 + second;
+    return true;
+}
+
+/*
+ * Convierte "a.b.c.d[:puerto]" a la clave numérica de los registros. Sin puerto, el inicio
+ * de un rango usa el puerto 0 y el fin el 65535, para abarcar todos los puertos de la IP.
+ * Complejidad: O(1).
+ * @return false si el texto no tiene cuatro octetos.
+ */
+bool parseQueryIP(const string& text, bool isEnd, unsigned long long& key) {
+    if (count(text.begin(), text.end(), '.') != 3) return false;
+    int octets[4], port;
+    const char* end = parseIPPort(text.data(), text.data() + text.size(), octets, port);
+    bool hasPort = text.find(':') != string::npos;
+    if (end != text.data() + text.size()) return false;
+    key = 0;
+    for (int octet : octets) key = (key << 10) | (octet & 1023);
+    key = (key << 16) | (hasPort ? port & 0xFFFF : isEnd ? 0xFFFF : 0);
+    return true;
+}
+
+/*
+ * Responde una consulta de solo lectura sobre una versión de la bitácora.
+ * Complejidad: O(log n + k), donde k es la cantidad de resultados.
+ */
+void answerQuery(const LogSnapshot& snapshot, const string& line, ostream& out) {
+    istringstream request(line);
+    string command;
+    request >> command;
+    vector<string> arguments;
+    for (string argument; request >> argument;) arguments.push_back(argument);
+
+    if (command == "FECHAS") {
+        // Cada fecha puede ir seguida de su hora
+        vector<pair<string, string>> bounds;
+        for (const string& argument : arguments) {
+            if (argument.find('-') != string::npos) bounds.push_back({argument, ""});
+            else if (!bounds.empty() && bounds.back().second.empty()) bounds.back().second = argument;
+            else bounds.clear();
+        }
+        int startTime, endTime;
+        if (bounds.size() != 2 || !parseQueryTime(bounds[0].first, bounds[0].second, false, startTime) ||
+            !parseQueryTime(bounds[1].first, bounds[1].second, true, endTime)) {
+            out << "ERROR uso: FECHAS MM-DD [hh[:mm[:ss]]] MM-DD [hh[:mm[:ss]]]\n";
+            return;
+        }
+        auto range = rangeBy<TimestampKey>(snapshot.byTime.begin(), snapshot.byTime.end(), startTime, endTime);
+        for (auto it = range.first; it != range.second; ++it) writeSortedEntry(out, snapshot.store, *it);
+    } else if (command == "IPS") {
+        unsigned long long startKey, endKey;
+        if (arguments.size() != 2 || !parseQueryIP(arguments[0], false, startKey) ||
+            !parseQueryIP(arguments[1], true, endKey)) {
+            out << "ERROR uso: IPS a.b.c.d[:puerto] a.b.c.d[:puerto]\n";
+            return;
+        }
+        auto range = rangeBy<IPKey>(snapshot.byIP.begin(), snapshot.byIP.end(), startKey, endKey);
+        for (auto it = range.first; it != range.second; ++it) writeSortedEntry(out, snapshot.store, *it);
+    } else if (command == "TOP") {
+        int k = arguments.size() == 1 ? atoi(arguments[0].c_str()) : 0;
+        if (k <= 0) {
+            out << "ERROR uso: TOP k\n";
+            return;
+        }
+        for (size_t i = 0; i < min<size_t>(k, snapshot.topIPs.size()); ++i) {
+            out << "IP: " << snapshot.topIPs[i].second << " - Accesos: " << -snapshot.topIPs[i].first << '\n';
+        }
+    } else if (command == "PUERTO") {
+        if (arguments.size() != 1) {
+            out << "ERROR uso: PUERTO p\n";
+            return;
+        }
+        long index = snapshot.graph.findPort(atoi(arguments[0].c_str()));
+        if (index < 0) {
+            out << "Puerto " << arguments[0] << " - Atacantes distintos: 0\n";
+            return;
+        }
+        const AttackGraph& graph = snapshot.graph;
+        out << "Puerto " << graph.ports[index] << " - Atacantes distintos: " << graph.fanOut(index) << '\n';
+        for (uint32_t i = graph.offsets[index]; i < graph.offsets[index + 1]; ++i) {
+            unsigned long long attacker = graph.attackers[graph.neighbours[i]];
+            out << formatIP(attacker >> 16) << ':' << (attacker & 0xFFFF) << '\n';
+        }
+    } else if (command == "PUERTOS") {
+        int k = arguments.size() == 1 ? atoi(arguments[0].c_str()) : 0;
+        if (k <= 0) {
+            out << "ERROR uso: PUERTOS k\n";
+            return;
+        }
+        for (size_t i = 0; i < min<size_t>(k, snapshot.portsByFanOut.size()); ++i) {
+            uint32_t index = snapshot.portsByFanOut[i];
+            out << "Puerto " << snapshot.graph.ports[index] << " - Atacantes distintos: "
+                << snapshot.graph.fanOut(index) << '\n';
+        }
+    } else if (command == "ESTADO") {
+        out << "Bitácora: " << snapshot.filename << " - Registros: " << snapshot.store.records.size()
+            << " - Puertos: " << snapshot.graph.ports.size() << " - Carga: " << snapshot.loadMilliseconds << " ms\n";
+    } else {
+        out << "ERROR consulta desconocida: " << command << '\n';
+    }
+}
+
+// Consulta completa de una conexión, lista para el grupo de hilos
+struct Request {
+    int connection;
+    string line;
+};
+
+// Cola de consultas que atienden los hilos del servicio
+class RequestQueue {
+private:
+    queue<Request> requests;
+    mutex lock;
+    condition_variable available;
+
+public:
+    void push(Request request) {
+        {
+            lock_guard<mutex> guard(lock);
+            requests.push(move(request));
+        }
+        available.notify_one();
+    }
+
+    Request pop() {
+        unique_lock<mutex> guard(lock);
+        available.wait(guard, [this]() { return !requests.empty(); });
+        Request request = move(requests.front());
+        requests.pop();
+        return request;
+    }
+};
+
+/*
+ * Servicio de consultas: guarda la versión publicada de la bitácora y atiende conexiones.
+ * Las consultas toman una referencia a la versión vigente con una carga atómica, así que
+ * nunca esperan a una recarga ni ven índices a medio construir.
+ */
+class QueryService {
+private:
+    shared_ptr<const LogSnapshot> snapshot;
+    mutex reloadLock; // Solo serializa las recargas entre sí
+
+    /*
+     * Carga una bitácora y publica sus índices.
+     * Complejidad: O(n log n), fuera de la ruta de las consultas.
+     */
+    void reload(const string& filename, ostream& out) {
+        lock_guard<mutex> guard(reloadLock);
+        shared_ptr<const LogSnapshot> next = loadSnapshot(filename);
+        if (!next) {
+            out << "ERROR no se pudo abrir el archivo: " << filename << '\n';
+            return;
+        }
+        atomic_store(&snapshot, next);
+        out << "Bitácora cargada: " << filename << " - Registros: " << next->store.records.size() << '\n';
+    }
+
+    /*
+     * Agrega los registros de otra bitácora a la versión vigente y publica el resultado.
+     * Complejidad: O(n + m log m), fuera de la ruta de las consultas.
+     */
+    void extend(const string& filename, ostream& out) {
+        lock_guard<mutex> guard(reloadLock);
+        shared_ptr<const LogSnapshot> current = atomic_load(&snapshot);
+        shared_ptr<const LogSnapshot> next = extendSnapshot(*current, filename);
+        if (!next) {
+            out << "ERROR no se pudo abrir el archivo: " << filename << '\n';
+            return;
+        }
+        atomic_store(&snapshot, next);
+        out << "Registros agregados: " << next->store.records.size() - current->store.records.size()
+            << " - Registros: " << next->store.records.size() << '\n';
+    }
+
+public:
+    explicit QueryService(shared_ptr<const LogSnapshot> initial) : snapshot(initial) {}
+
+    /*
+     * Responde una línea del protocolo.
+     * Complejidad: la de la consulta.
+     */
+    string answer(const string& line) {
+        ostringstream out;
+        if (line.compare(0, 7, "CARGAR ") == 0) {
+            reload(line.substr(7), out);
+        } else if (line.compare(0, 8, "AGREGAR ") == 0) {
+            extend(line.substr(8), out);
+        } else {
+            shared_ptr<const LogSnapshot> current = atomic_load(&snapshot);
+            answerQuery(*current, line, out);
+        }
+        out << "FIN\n";
+        return out.str();
+    }
+
+    /*
+     * Responde una consulta y envía la respuesta completa por la conexión.
+     * Complejidad: la de la consulta.
+     * @return false si la conexión se cerró o falló el envío.
+     */
+    bool respond(int connection, const string& line) {
+        string response = answer(line);
+        for (size_t sent = 0; sent < response.size();) {
+            ssize_t written = send(connection, response.data() + sent, response.size() - sent, MSG_NOSIGNAL);
+            if (written <= 0) return false;
+            sent += written;
+        }
+        return true;
+    }
+};
+
+/*
+ * Reparte las consultas entre el grupo de hilos. El hilo que llama a run espera con poll
+ * a todas las conexiones, lee lo que llega sin bloquearse y entrega cada línea completa
+ * como una consulta. Mientras una conexión tiene una consulta en curso no se le entrega
+ * otra (así sus respuestas salen en orden); al terminar, el hilo de trabajo la regresa
+ * por una tubería que despierta a poll.
+ */
+class RequestDispatcher {
+private:
+    // Estado de una conexión abierta (solo lo usa el hilo de poll)
+    struct Connection {
+        string pending;       // Bytes recibidos que aún no forman consultas entregadas
+        bool busy = false;    // Tiene una consulta en el grupo de hilos
+        bool closing = false; // El cliente ya no enviará más (se responden las pendientes)
+    };
+
+    QueryService& service;
+    RequestQueue requests;
+    vector<thread> workers;
+    unordered_map<int, Connection> connections;
+    int wakeRead = -1, wakeWrite = -1;
+    mutex finishedLock;
+    vector<pair<int, bool>> finished; // (conexión, sigue abierta) de las consultas terminadas
+
+    // Cierra una conexión y olvida su estado
+    void drop(int connection) {
+        close(connection);
+        connections.erase(connection);
+    }
+
+    // Entrega la siguiente consulta completa de una conexión libre, o la cierra si ya no habrá más
+    void dispatch(int connection) {
+        Connection& state = connections[connection];
+        if (state.busy) return;
+        size_t lineStart = 0, lineEnd;
+        while ((lineEnd = state.pending.find('\n', lineStart)) != string::npos) {
+            string line = state.pending.substr(lineStart, lineEnd - lineStart);
+            if (!line.empty() && line.back() == '\r') line.pop_back();
+            lineStart = lineEnd + 1;
+            if (line.empty()) continue;
+            state.pending.erase(0, lineStart);
+            state.busy = true;
+            requests.push({connection, move(line)});
+            return;
+        }
+        state.pending.erase(0, lineStart);
+        if (state.closing) drop(connection);
+    }
+
+    // Lee lo que haya llegado por una conexión sin bloquearse
+    void receive(int connection) {
+        char block[4096];
+        ssize_t received = recv(connection, block, sizeof(block), MSG_DONTWAIT);
+        if (received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) return;
+        Connection& state = connections[connection];
+        if (received > 0) state.pending.append(block, received);
+        else state.closing = true;
+        dispatch(connection);
+    }
+
+    // Regresa al poll las conexiones cuyas consultas terminaron
+    void collectFinished() {
+        char drain[64];
+        while (read(wakeRead, drain, sizeof(drain)) > 0) {}
+        vector<pair<int, bool>> done;
+        {
+            lock_guard<mutex> guard(finishedLock);
+            done.swap(finished);
+        }
+        for (const pair<int, bool>& entry : done) {
+            if (!entry.second) {
+                drop(entry.first);
+                continue;
+            }
+            connections[entry.first].busy = false;
+            dispatch(entry.first);
+        }
+    }
+
+public:
+    /*
+     * Inicia el grupo de hilos.
+     * @param threads Cantidad de hilos que responden consultas.
+     */
+    RequestDispatcher(QueryService& service, unsigned threads) : service(service) {
+        int wake[2];
+        if (pipe2(wake, O_CLOEXEC | O_NONBLOCK) == 0) {
+            wakeRead = wake[0];
+            wakeWrite = wake[1];
+        }
+        for (unsigned i = 0; i < threads; ++i) {
+            workers.emplace_back([this]() {
+                while (true) {
+                    Request request = requests.pop();
+                    bool open = this->service.respond(request.connection, request.line);
+                    {
+                        lock_guard<mutex> guard(finishedLock);
+                        finished.push_back({request.connection, open});
+                    }
+                    char signal = 1;
+                    ssize_t ignored = write(wakeWrite, &signal, 1); // Si la tubería está llena, poll ya despertará
+                    (void)ignored;
+                }
+            });
+        }
+    }
+
+    // Indica si la tubería para despertar a poll se pudo crear
+    bool ready() const { return wakeRead >= 0; }
+
+    /*
+     * Acepta conexiones y reparte sus consultas indefinidamente.
+     * Complejidad: O(c) por cada espera de poll, donde c es la cantidad de conexiones abiertas.
+     */
+    void run(int listener) {
+        vector<pollfd> watched;
+        while (true) {
+            watched.assign({{listener, POLLIN, 0}, {wakeRead, POLLIN, 0}});
+            for (const auto& entry : connections) {
+                if (!entry.second.busy && !entry.second.closing) watched.push_back({entry.first, POLLIN, 0});
+            }
+            if (poll(watched.data(), watched.size(), -1) < 0) continue;
+
+            if (watched[1].revents) collectFinished();
+            for (size_t i = 2; i < watched.size(); ++i) {
+                if (watched[i].revents) receive(watched[i].fd);
+            }
+            if (watched[0].revents & POLLIN) {
+                int connection = accept(listener, nullptr, nullptr);
+                if (connection >= 0) connections[connection];
+            }
+        }
+    }
+};
+
+/*
+ * Abre el socket de escucha: Unix en `socketPath`, o TCP en 127.0.0.1 si `tcpPort` > 0.
+ * Complejidad: O(1).
+ * @return Descriptor del socket, o -1 si no se pudo abrir.
+ */
+int openListener(const string& socketPath, int tcpPort) {
+    int listener;
+    if (tcpPort > 0) {
+        listener = socket(AF_INET, SOCK_STREAM, 0);
+        if (listener < 0) return -1;
+        int enable = 1;
+        setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+        sockaddr_in address = {};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        address.sin_port = htons(tcpPort);
+        if (bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+            close(listener);
+            return -1;
+        }
+    } else {
+        listener = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (listener < 0) return -1;
+        sockaddr_un address = {};
+        address.sun_family = AF_UNIX;
+        if (socketPath.size() >= sizeof(address.sun_path)) {
+            close(listener);
+            return -1;
+        }
+        strcpy(address.sun_path, socketPath.c_str());
+        unlink(socketPath.c_str());
+        if (bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+            close(listener);
+            return -1;
+        }
+    }
+    if (listen(listener, 128) != 0) {
+        close(listener);
+        return -1;
+    }
+    return listener;
+}
+
+int main(int argc, char* argv[]) {
+    string filename = "bitacora.txt";
+    string socketPath = DEFAULT_SOCKET_PATH;
+    int tcpPort = 0;
+    unsigned threads = max(4u, thread::hardware_concurrency());
+    for (int i = 1; i < argc; ++i) {
+        string argument = argv[i];
+        if (argument == "--socket" && i + 1 < argc) socketPath = argv[++i];
+        else if (argument == "--tcp" && i + 1 < argc) tcpPort = atoi(argv[++i]);
+        else if (argument == "--hilos" && i + 1 < argc) threads = max(1, atoi(argv[++i]));
+        else filename = argument;
+    }
+
+    shared_ptr<const LogSnapshot> initial = loadSnapshot(filename);
+    if (!initial) {
+        cerr << "Error al abrir el archivo: " << filename << endl;
+        return 1;
+    }
+    QueryService service(initial);
+
+    int listener = openListener(socketPath, tcpPort);
+    if (listener < 0) {
+        cerr << "Error al abrir el socket: " << strerror(errno) << endl;
+        return 1;
+    }
+    cout << "Registros cargados: " << initial->store.records.size() << " en " << initial->loadMilliseconds
+         << " ms" << endl;
+    cout << "Escuchando en " << (tcpPort > 0 ? "127.0.0.1:" + to_string(tcpPort) : socketPath) << " con "
+         << threads << " hilos" << endl;
+
+    // Grupo de hilos: cada uno responde una consulta a la vez, de cualquier conexión
+    RequestDispatcher dispatcher(service, threads);
+    if (!dispatcher.ready()) {
+        cerr << "Error al crear la tubería del servicio: " << strerror(errno) << endl;
+        return 1;
+    }
+    dispatcher.run(listener);
+}